@@ -0,0 +1,260 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Config.h"
+#include "Frame.h"
+
+#include <Arduino.h>
+
+#if !LCD_FEATURE_GLYPHS
+#error "BarGraph needs special characters, LCD_FEATURE_GLYPHS is 0"
+#endif
+
+namespace lcd {
+/**
+ * @brief Base class of bars which are drawn with special characters showing
+ * partially filled cells. Only the cells whose content changed are rewritten
+ * when the value changes.
+ */
+class BarGraphBase {
+public:
+  /**
+   * @brief Character code of a completely filled cell (part of the character
+   * ROM of the HD44780)
+   */
+  const static uint8_t fullCell = 0xFF;
+
+protected:
+  /**
+   * @brief Number of cells of the bar
+   */
+  const uint8_t length;
+
+protected:
+  /**
+   * @brief Number of steps which can be shown by one cell
+   */
+  const uint8_t unitsPerCell;
+
+protected:
+  /**
+   * @brief Number of the first special character used for partially filled
+   * cells
+   */
+  const uint8_t firstCharacter;
+
+protected:
+  /**
+   * @brief Number of filled units which are currently drawn or -1 if nothing
+   * was drawn yet
+   */
+  int drawnUnits;
+
+public:
+  /**
+   * @brief Construct a new bar
+   *
+   * @param length number of cells of the bar
+   * @param unitsPerCell number of steps which can be shown by one cell
+   * @param firstCharacter number of the first special character used for
+   * partially filled cells. unitsPerCell - 1 characters are used.
+   */
+  BarGraphBase(const uint8_t& length, const uint8_t& unitsPerCell, const uint8_t& firstCharacter)
+    : length(length)
+    , unitsPerCell(unitsPerCell)
+    , firstCharacter(firstCharacter)
+    , drawnUnits(-1) {}
+
+public:
+  /**
+   * @brief Destroy the bar
+   */
+  virtual ~BarGraphBase() {}
+
+public:
+  /**
+   * @brief Forces a complete redraw during the next update, e.g. after the
+   * display was cleared
+   */
+  void invalidate() {
+    drawnUnits = -1;
+  }
+
+public:
+  /**
+   * @brief Shows a new value. Only the cells between the old and the new end
+   * of the bar are written.
+   *
+   * @param display the frame in which the bar is drawn
+   * @param value the value to show
+   * @param maximum the value of a completely filled bar
+   */
+  void setValue(Frame* display, const long& value, const long& maximum) {
+    const long totalUnits = (long)length * unitsPerCell;
+    long units = maximum <= 0 ? 0 : (value * totalUnits + maximum / 2) / maximum;
+    units = units < 0 ? 0 : (units > totalUnits ? totalUnits : units);
+
+    if (drawnUnits < 0) {
+      for (uint8_t cell = 0; cell < length; cell++) {
+        drawCell(display, cell, units);
+      }
+    }
+    else if (units != drawnUnits) {
+      // only the cells between the old and the new boundary change
+      const long from = (units < drawnUnits ? units : drawnUnits) / unitsPerCell;
+      long to = (units > drawnUnits ? units : drawnUnits) / unitsPerCell;
+      to = to < length ? to : length - 1;
+      for (long cell = from; cell <= to; cell++) {
+        drawCell(display, cell, units);
+      }
+    }
+    drawnUnits = units;
+  }
+
+protected:
+  /**
+   * @brief Returns the character of a cell
+   *
+   * @param cell index of the cell
+   * @param units number of filled units of the complete bar
+   */
+  uint8_t getCellCharacter(const uint8_t& cell, const long& units) const {
+    const long filled = units - (long)cell * unitsPerCell;
+    if (filled >= unitsPerCell) {
+      return fullCell;
+    }
+    else if (filled <= 0) {
+      return ' ';
+    }
+    return firstCharacter + filled - 1;
+  }
+
+protected:
+  /**
+   * @brief Writes one cell
+   *
+   * @param display the frame in which the bar is drawn
+   * @param cell index of the cell
+   * @param units number of filled units of the complete bar
+   */
+  virtual void drawCell(Frame* display, const uint8_t& cell, const long& units) = 0;
+};
+
+/**
+ * @brief Horizontal bar filled from left to right with a resolution of one
+ * pixel column. Uses 4 special characters, by default the ones of the WIFI
+ * signal symbols.
+ */
+class ProgressBar : public BarGraphBase {
+protected:
+  /**
+   * @brief Display-column of the left end
+   */
+  const uint8_t column;
+
+protected:
+  /**
+   * @brief Display-row of the bar
+   */
+  const uint8_t row;
+
+public:
+  /**
+   * @brief Construct a new bar
+   *
+   * @param column display-column of the left end
+   * @param row display-row of the bar
+   * @param length number of cells of the bar
+   * @param firstCharacter number of the first of 4 special characters used
+   * for partially filled cells
+   */
+  ProgressBar(const uint8_t& column, const uint8_t& row, const uint8_t& length, const uint8_t& firstCharacter = 3)
+    : BarGraphBase(length, 5, firstCharacter)
+    , column(column)
+    , row(row) {}
+
+public:
+  /**
+   * @brief Writes the special characters to the display. Must be called when
+   * the view containing the bar is activated.
+   */
+  void initializeSpecialCharacters(Frame* display) {
+    uint8_t customChar[8];
+    for (uint8_t filled = 1; filled < 5; filled++) {
+      std::fill_n(customChar, 8, (uint8_t)(0x1F & ~(0x1F >> filled)));
+      display->createChar(firstCharacter + filled - 1, customChar);
+    }
+    invalidate();
+  }
+
+protected:
+  /**
+   * @brief Writes one cell
+   */
+  virtual void drawCell(Frame* display, const uint8_t& cell, const long& units) {
+    display->setCursor(column + cell, row);
+    display->write(getCellCharacter(cell, units));
+  }
+};
+
+/**
+ * @brief Vertical bar filled from bottom to top with a resolution of two
+ * pixel rows. Uses 3 special characters, by default the ones of the WIFI
+ * signal symbols.
+ */
+class VerticalBar : public BarGraphBase {
+protected:
+  /**
+   * @brief Display-column of the bar
+   */
+  const uint8_t column;
+
+protected:
+  /**
+   * @brief Display-row of the bottom end
+   */
+  const uint8_t bottomRow;
+
+public:
+  /**
+   * @brief Construct a new bar
+   *
+   * @param column display-column of the bar
+   * @param bottomRow display-row of the bottom end
+   * @param height number of cells of the bar
+   * @param firstCharacter number of the first of 3 special characters used
+   * for partially filled cells
+   */
+  VerticalBar(const uint8_t& column, const uint8_t& bottomRow, const uint8_t& height, const uint8_t& firstCharacter = 3)
+    : BarGraphBase(height, 4, firstCharacter)
+    , column(column)
+    , bottomRow(bottomRow) {}
+
+public:
+  /**
+   * @brief Writes the special characters to the display. Must be called when
+   * the view containing the bar is activated.
+   */
+  void initializeSpecialCharacters(Frame* display) {
+    uint8_t customChar[8];
+    for (uint8_t filled = 1; filled < 4; filled++) {
+      std::fill_n(customChar, 8, 0);
+      std::fill_n(customChar + 8 - 2 * filled, 2 * filled, 0x1F);
+      display->createChar(firstCharacter + filled - 1, customChar);
+    }
+    invalidate();
+  }
+
+protected:
+  /**
+   * @brief Writes one cell
+   */
+  virtual void drawCell(Frame* display, const uint8_t& cell, const long& units) {
+    display->setCursor(column, bottomRow - cell);
+    display->write(getCellCharacter(cell, units));
+  }
+};
+} // namespace lcd
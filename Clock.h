@@ -0,0 +1,152 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <Arduino.h>
+
+namespace lcd {
+/**
+ * @brief Source of the time used by the library. By default the time of the
+ * board is used. Another clock can be installed using Clock::set, e.g. a
+ * SimulatedClock to test the behavior over weeks of uptime in seconds.
+ *
+ * The values are 32 bit and wrap around like millis and micros on the boards,
+ * also on hosts with 64 bit longs. Deadlines must be compared using reached
+ * and durations using the difference of two values.
+ */
+class Clock {
+public:
+  /**
+   * @brief Destroy the clock
+   */
+  virtual ~Clock() {}
+
+public:
+  /**
+   * @brief Returns the current time in milliseconds
+   */
+  virtual uint32_t millis() {
+    return ::millis();
+  }
+
+public:
+  /**
+   * @brief Returns the current time in microseconds
+   */
+  virtual uint32_t micros() {
+    return ::micros();
+  }
+
+public:
+  /**
+   * @brief Returns true if a deadline is reached. The comparison is correct
+   * across the wraparound as long as the deadline is less than half of the
+   * value range away.
+   *
+   * @param now the current time
+   * @param deadline the time to compare with
+   */
+  static bool reached(const uint32_t& now, const uint32_t& deadline) {
+    return (int32_t)(now - deadline) >= 0;
+  }
+
+public:
+  /**
+   * @brief Returns the installed clock
+   */
+  static Clock& get() {
+    return *getInstance();
+  }
+
+public:
+  /**
+   * @brief Installs a clock
+   *
+   * @param clock the new clock or nullptr to use the time of the board
+   */
+  static void set(Clock* clock) {
+    getInstance() = clock ? clock : &getSystemClock();
+  }
+
+protected:
+  /**
+   * @brief Returns the singleton reading the time of the board
+   */
+  static Clock& getSystemClock() {
+    static Clock clock;
+    return clock;
+  }
+
+protected:
+  /**
+   * @brief Returns the pointer to the installed clock
+   */
+  static Clock*& getInstance() {
+    static Clock* clock = &getSystemClock();
+    return clock;
+  }
+};
+
+/**
+ * @brief Clock which only advances when told to, e.g. to fast-forward days of
+ * uptime on the host. The start value can be chosen close to the wraparound.
+ *
+ * Example:
+ * @code
+ * lcd::SimulatedClock clock(0xFFFF0000);
+ * lcd::Clock::set(&clock);
+ * for (int i = 0; i < 60 * 24 * 60; i++) {
+ *   clock.advance(60000);
+ *   lcd::ViewBase::getCurrentView()->tick(false);
+ * }
+ * @endcode
+ */
+class SimulatedClock : public Clock {
+protected:
+  /**
+   * @brief The current time in microseconds
+   */
+  unsigned long long now;
+
+public:
+  /**
+   * @brief Construct a new clock
+   *
+   * @param startMillis the initial millis value
+   */
+  SimulatedClock(const uint32_t& startMillis = 0)
+    : now((unsigned long long)startMillis * 1000) {}
+
+public:
+  virtual uint32_t millis() {
+    return (uint32_t)(now / 1000);
+  }
+
+public:
+  virtual uint32_t micros() {
+    return (uint32_t)now;
+  }
+
+public:
+  /**
+   * @brief Advances the time
+   *
+   * @param milliseconds the number of milliseconds which passed
+   */
+  void advance(const unsigned long& milliseconds) {
+    now += (unsigned long long)milliseconds * 1000;
+  }
+
+public:
+  /**
+   * @brief Advances the time
+   *
+   * @param microseconds the number of microseconds which passed
+   */
+  void advanceMicros(const unsigned long& microseconds) {
+    now += microseconds;
+  }
+};
+} // namespace lcd
@@ -0,0 +1,91 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+/**
+ * Compile-time configuration of the library. Every switch can be overridden
+ * by defining it before the library is included, e.g. using build flags:
+ * @code
+ * build_flags = -DLCD_FEATURE_MARQUEE=0 -DLCD_FEATURE_LOGGING=0
+ * @endcode
+ */
+
+/**
+ * If 0 the dialogs are not available, including DialogBase.h fails
+ */
+#ifndef LCD_FEATURE_DIALOGS
+#define LCD_FEATURE_DIALOGS 1
+#endif
+
+/**
+ * If 0 texts which are longer than the display are cut instead of scrolled.
+ * This removes the animation state from every menu item.
+ */
+#ifndef LCD_FEATURE_MARQUEE
+#define LCD_FEATURE_MARQUEE 1
+#endif
+
+/**
+ * If 0 no special characters are used. The bitmaps are not stored, the
+ * scrollbar is drawn with characters of the LCD's ROM and views which need
+ * special characters (SparklineView, BarGraph) are not available.
+ */
+#ifndef LCD_FEATURE_GLYPHS
+#define LCD_FEATURE_GLYPHS 1
+#endif
+
+/**
+ * If 0 all log messages are removed, see LCD_LOG_LEVEL in Log.h
+ */
+#ifndef LCD_FEATURE_LOGGING
+#define LCD_FEATURE_LOGGING 1
+#endif
+
+/**
+ * Header defining the size budgets, e.g. written by tools/footprint.py. Must
+ * be defined including the quotes: -DLCD_SIZE_BUDGETS='"lcd_budgets.h"'
+ */
+#ifdef LCD_SIZE_BUDGETS
+#include LCD_SIZE_BUDGETS
+#endif
+
+/**
+ * Maximum sizes in bytes of the classes, 0 if the size is not checked. The
+ * sizes depend on the platform and the configuration, so they are measured
+ * by tools/footprint.py instead of being defined here.
+ */
+#ifndef LCD_BUDGET_FRAME
+#define LCD_BUDGET_FRAME 0
+#endif
+#ifndef LCD_BUDGET_MENU_VIEW
+#define LCD_BUDGET_MENU_VIEW 0
+#endif
+#ifndef LCD_BUDGET_MENU_ITEM
+#define LCD_BUDGET_MENU_ITEM 0
+#endif
+#ifndef LCD_BUDGET_STATIC_MENU_VIEW
+#define LCD_BUDGET_STATIC_MENU_VIEW 0
+#endif
+#ifndef LCD_BUDGET_MENU_FILE_VIEW
+#define LCD_BUDGET_MENU_FILE_VIEW 0
+#endif
+#ifndef LCD_BUDGET_TABLE_VIEW
+#define LCD_BUDGET_TABLE_VIEW 0
+#endif
+#ifndef LCD_BUDGET_DIALOG
+#define LCD_BUDGET_DIALOG 0
+#endif
+#ifndef LCD_BUDGET_VALUE_EDIT_VIEW
+#define LCD_BUDGET_VALUE_EDIT_VIEW 0
+#endif
+#ifndef LCD_BUDGET_SPARKLINE_VIEW
+#define LCD_BUDGET_SPARKLINE_VIEW 0
+#endif
+
+/**
+ * Fails the build if a class is larger than its budget
+ */
+#define LCD_ASSERT_SIZE(type, budget) \
+  static_assert(((budget) == 0) || (sizeof(type) <= (budget)), #type " exceeds " #budget ", see Config.h")
@@ -0,0 +1,184 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+/**
+ * Starts the body of Coroutine::run
+ */
+#define LCD_CO_BEGIN()       \
+  switch (coroutineState) {  \
+  case 0:
+
+/**
+ * Returns from run until the passed future is ready. The future must be a
+ * member of the coroutine since local variables are lost while waiting.
+ */
+#define LCD_CO_AWAIT(future)    \
+  do {                          \
+    coroutineState = __LINE__;  \
+    /* fall through */          \
+  case __LINE__:                \
+    if (!(future).ready()) {    \
+      return true;              \
+    }                           \
+  } while (0)
+
+/**
+ * Returns from run and continues at this position during the next resume
+ */
+#define LCD_CO_YIELD()         \
+  do {                         \
+    coroutineState = __LINE__; \
+    return true;               \
+  case __LINE__:;              \
+  } while (0)
+
+/**
+ * Ends the body of Coroutine::run
+ */
+#define LCD_CO_END()    \
+  }                     \
+  coroutineState = -1;  \
+  return false;
+
+namespace lcd {
+/**
+ * @brief Result of an asynchronous operation, e.g. of a dialog. The future
+ * only references the state of its owner, so it does not allocate memory.
+ */
+template <typename T>
+class Future {
+protected:
+  /**
+   * @brief Points to true as soon as the result is available
+   */
+  const bool* done;
+
+protected:
+  /**
+   * @brief Points to the result
+   */
+  const T* value;
+
+public:
+  /**
+   * @brief Construct a future which is never ready
+   */
+  Future()
+    : done(nullptr)
+    , value(nullptr) {}
+
+public:
+  /**
+   * @brief Construct a future
+   *
+   * @param done points to true as soon as the result is available
+   * @param value points to the result
+   */
+  Future(const bool* done, const T* value)
+    : done(done)
+    , value(value) {}
+
+public:
+  /**
+   * @brief Returns true as soon as the result is available
+   */
+  bool ready() const {
+    return done && *done;
+  }
+
+public:
+  /**
+   * @brief Get the result. Only valid if ready returns true.
+   */
+  const T& get() const {
+    return *value;
+  }
+};
+
+/**
+ * @brief Base class for stackless coroutines. The body of run is enclosed by
+ * LCD_CO_BEGIN and LCD_CO_END and may wait for futures using LCD_CO_AWAIT
+ * without blocking the loop function. The state of a coroutine is a single
+ * integer plus the members of the derived class, so its memory footprint is
+ * known at compile time. Since run is re-entered, local variables do not
+ * survive LCD_CO_AWAIT and LCD_CO_YIELD and no switch statement may enclose
+ * them.
+ *
+ * Example:
+ * @code
+ * class ResetTask : public lcd::Coroutine {
+ *   lcd::Future<bool> answer;
+ *   virtual bool run() {
+ *     LCD_CO_BEGIN();
+ *     answer = resetDialog.ask(false);
+ *     LCD_CO_AWAIT(answer);
+ *     if (answer.get()) {
+ *       reset();
+ *     }
+ *     LCD_CO_END();
+ *   }
+ * };
+ * @endcode
+ */
+class Coroutine {
+protected:
+  /**
+   * @brief Line at which run continues, 0 at the beginning and -1 after the
+   * end
+   */
+  int coroutineState;
+
+public:
+  /**
+   * @brief Construct a new coroutine
+   */
+  Coroutine()
+    : coroutineState(0) {}
+
+public:
+  /**
+   * @brief Destroy the coroutine
+   */
+  virtual ~Coroutine() {}
+
+public:
+  /**
+   * @brief Continues the coroutine. Must be called in the loop function.
+   *
+   * @return false as soon as the coroutine finished
+   */
+  bool resume() {
+    if (coroutineState == -1) {
+      return false;
+    }
+    return run();
+  }
+
+public:
+  /**
+   * @brief Returns true if the coroutine finished
+   */
+  bool isFinished() const {
+    return coroutineState == -1;
+  }
+
+public:
+  /**
+   * @brief Starts the coroutine again from the beginning
+   */
+  void restart() {
+    coroutineState = 0;
+  }
+
+protected:
+  /**
+   * @brief Body of the coroutine
+   *
+   * @return true while the coroutine is running
+   */
+  virtual bool run() = 0;
+};
+} // namespace lcd
@@ -4,11 +4,18 @@
  */
 #pragma once
 
+#include "Config.h"
+#include "Coroutine.h"
+#include "StringTable.h"
 #include "ViewBase.h"
 
 #include <Arduino.h>
 #include <RotaryEncoder.h>
-#include <list>
+#include <algorithm>
+
+#if !LCD_FEATURE_DIALOGS
+#error "Dialogs are disabled, LCD_FEATURE_DIALOGS is 0"
+#endif
 
 namespace lcd {
 /**
@@ -27,6 +34,18 @@ protected:
    */
   String rows[3];
 
+protected:
+  /**
+   * @brief true as soon as the dialog was closed
+   */
+  bool closed;
+
+protected:
+  /**
+   * @brief Number of the text in the string tables or noText
+   */
+  TextId textId;
+
 public:
   /**
    * @brief Number of display-columns
@@ -58,9 +77,72 @@ public:
              const int& numberOfRows)
     : ViewBase(display, name)
     , encoder(encoder)
+    , closed(true)
+    , textId(noText)
     , numberOfColumns(numberOfColumns)
     , numberOfRows(numberOfRows) {
-    for (int i = 0; i < numberOfRows - 1; i++) {
+    ViewBase::display->setSize(numberOfColumns, numberOfRows);
+    getInput().useEncoder(encoder);
+    setText(text);
+  }
+
+public:
+  /**
+   * @brief Construct a new Dialog whose text is read from the current string
+   * table every time it is shown
+   *
+   * @param display pointer to the display instance
+   * @param name The name of the view
+   * @param encoder pointer to the encoder instance
+   * @param text number of the text in the string tables
+   * @param numberOfColumns number of display-columns
+   * @param numberOfRows number of display-rows
+   */
+  DialogBase(LiquidCrystal_PCF8574* display,
+             const String& name,
+             RotaryEncoder* encoder,
+             const TextId& text,
+             const int& numberOfColumns,
+             const int& numberOfRows)
+    : ViewBase(display, name)
+    , encoder(encoder)
+    , closed(true)
+    , textId(text)
+    , numberOfColumns(numberOfColumns)
+    , numberOfRows(numberOfRows) {
+    ViewBase::display->setSize(numberOfColumns, numberOfRows);
+    getInput().useEncoder(encoder);
+  }
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  DialogBase(const DialogBase& other) = delete;
+
+public:
+  /**
+   * @brief Move constructor
+   */
+  DialogBase(DialogBase&& other) noexcept = delete;
+
+public:
+  /**
+   * @brief Returns true if the dialog is closed
+   */
+  bool isClosed() const {
+    return closed;
+  }
+
+protected:
+  /**
+   * @brief Splits the text into the rows above the buttons
+   */
+  void setText(String text) {
+    for (auto& row : rows) {
+      row = String();
+    }
+    for (int i = 0; i < getNumberOfTextRows(); i++) {
       auto linebreak1 = text.indexOf('\n');
       if (linebreak1 != -1) {
         rows[i] = text.substring(0, linebreak1);
@@ -73,30 +155,60 @@ public:
     }
   }
 
-public:
+protected:
   /**
-   * @brief Copy constructor - not available
+   * @brief Returns the number of rows showing the text
    */
-  DialogBase(const DialogBase& other) = delete;
+  int getNumberOfTextRows() const {
+    return std::min(numberOfRows - 1, 3);
+  }
 
-public:
+protected:
   /**
-   * @brief Move constructor
+   * @brief Closes the dialog and activates the previous view again
    */
-  DialogBase(DialogBase&& other) noexcept = delete;
+  void close() {
+    closed = true;
+    activatePreviousView();
+  }
+
+protected:
+  /**
+   * @brief Ticks the dialog until it is closed. Used by the blocking showModal
+   * functions.
+   */
+  void runModal() {
+    while (!closed) {
+      if (encoder) {
+        encoder->tick();
+      }
+      tick(false);
+      delay(100);
+    }
+  }
 
 protected:
   /**
    * @brief called as soon as the view becomes active
    */
   virtual void activate() {
+    closed = false;
+    // ignore the click which opened the dialog
+    getInput().discard();
+
+    if (textId != noText) {
+      setText(StringTable::translate(textId));
+    }
+
+    // the last row shows the buttons, longer lines are cut
     display->clear();
-    display->setCursor(0, 0);
-    display->print(rows[0]);
-    display->setCursor(0, 1);
-    display->print(rows[1]);
-    display->setCursor(0, 2);
-    display->print(rows[2]);
+    for (int i = 0; i < getNumberOfTextRows(); i++) {
+      display->setCursor(0, i);
+      display->write(rows[i].c_str(), std::min((int)rows[i].length(), numberOfColumns));
+    }
+    display->present();
   }
 };
-} 
\ No newline at end of file
+
+LCD_ASSERT_SIZE(DialogBase, LCD_BUDGET_DIALOG);
+} // namespace lcd
\ No newline at end of file
@@ -28,6 +28,24 @@ public:
            const int& numberOfRows)
     : DialogBase(display, "OK Dialog", encoder, text, numberOfColumns, numberOfRows) {}
 
+public:
+  /**
+   * @brief Construct a new Dialog whose text is read from the current string
+   * table every time it is shown
+   *
+   * @param display pointer to the display instance
+   * @param encoder pointer to the encoder instance
+   * @param text number of the text in the string tables
+   * @param numberOfColumns number of display-columns
+   * @param numberOfRows number of display-rows
+   */
+  DialogOk(LiquidCrystal_PCF8574* display,
+           RotaryEncoder* encoder,
+           const TextId& text,
+           const int& numberOfColumns,
+           const int& numberOfRows)
+    : DialogBase(display, "OK Dialog", encoder, text, numberOfColumns, numberOfRows) {}
+
 public:
   /**
    * @brief Copy constructor - not available
@@ -47,7 +65,20 @@ public:
    */
   void showModal() {
     lcd::ViewBase::activateView(this);
-    activatePreviousView();
+    runModal();
+  }
+
+public:
+  /**
+   * @brief Shows the dialog without blocking. The current view must be ticked
+   * in the loop function. After closing the dialog the previous view is
+   * activated again.
+   *
+   * @return future which is ready as soon as the dialog is closed
+   */
+  Future<bool> ask() {
+    lcd::ViewBase::activateView(this);
+    return Future<bool>(&closed, &closed);
   }
 
 protected:
@@ -57,34 +88,34 @@ protected:
   virtual void activate() {
     DialogBase::activate();
 
-    display->setCursor((numberOfColumns - 4) / 2, 3);
+    display->setCursor((numberOfColumns - 4) / 2, numberOfRows - 1);
     display->print(">OK<");
-
-    auto encoderClicked = encoder->getNewClick();
-    while (!encoderClicked) {
-      encoder->tick();
-      auto encoderUpdate = encoder->getDirection();
-      encoderClicked = encoder->getNewClick();
-
-      // Update the backlight timeout
-      if (encoderClicked || (encoderUpdate != RotaryEncoder::Direction::NOROTATION)) {
-        if (!getBacklightTimeoutManager().delayTimeout()) {
-          encoderClicked = false;
-          continue;
-        }
-      }
-      getBacklightTimeoutManager().tick(display);
-
-      delay(100);
-    }
   }
 
-protected:
+public:
   /**
    * @brief called during the loop function
    *
    * @param forceRedraw if true everything should be redrawn
    */
-  virtual void tick(const bool& forceRedraw) {}
+  virtual void tick(const bool& forceRedraw) {
+    const InputEvent event = readInput();
+
+    // Update the backlight timeout
+    if (event != InputEvent::none) {
+      if (!getBacklightTimeoutManager().delayTimeout()) {
+        getBacklightTimeoutManager().tick(display);
+        display->present();
+        return;
+      }
+    }
+    getBacklightTimeoutManager().tick(display);
+
+    if ((event == InputEvent::select) || (event == InputEvent::back)) {
+      close();
+      return;
+    }
+    display->present();
+  }
 };
-} // namespace lcd
\ No newline at end of file
+} // namespace lcd
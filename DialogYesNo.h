@@ -8,7 +8,8 @@
 
 namespace lcd {
 /**
- * @brief Dialog with a yes and a no button
+ * @brief Dialog with a yes and a no button. Needs a display with at least 10
+ * columns.
  */
 class DialogYesNo : public DialogBase {
 protected:
@@ -41,6 +42,25 @@ public:
     : DialogBase(display, "Yes/No Dialog", encoder, text, numberOfColumns, numberOfRows)
     , yesSelected(true) {}
 
+public:
+  /**
+   * @brief Construct a new Dialog whose text is read from the current string
+   * table every time it is shown
+   *
+   * @param display pointer to the display instance
+   * @param encoder pointer to the encoder instance
+   * @param text number of the text in the string tables
+   * @param numberOfColumns number of display-columns
+   * @param numberOfRows number of display-rows
+   */
+  DialogYesNo(LiquidCrystal_PCF8574* display,
+              RotaryEncoder* encoder,
+              const TextId& text,
+              const int& numberOfColumns,
+              const int& numberOfRows)
+    : DialogBase(display, "Yes/No Dialog", encoder, text, numberOfColumns, numberOfRows)
+    , yesSelected(true) {}
+
 public:
   /**
    * @brief Copy constructor - not available
@@ -65,10 +85,27 @@ public:
   bool showModal(const bool& yesSelected) {
     this->yesSelected = yesSelected;
     lcd::ViewBase::activateView(this);
-    activatePreviousView();
+    runModal();
     return this->yesSelected;
   }
 
+public:
+  /**
+   * @brief Shows the dialog without blocking. The current view must be ticked
+   * in the loop function. After closing the dialog the previous view is
+   * activated again.
+   *
+   * @param yesSelected if true yes is selected by default as soon as the the
+   * dialog is displayed
+   * @return future which is ready as soon as the dialog is closed and which
+   * contains true if yes was selected
+   */
+  Future<bool> ask(const bool& yesSelected) {
+    this->yesSelected = yesSelected;
+    lcd::ViewBase::activateView(this);
+    return Future<bool>(&closed, &this->yesSelected);
+  }
+
 protected:
   /**
    * @brief called as soon as the view becomes active
@@ -76,55 +113,64 @@ protected:
   virtual void activate() {
     DialogBase::activate();
     lastDrawState = !yesSelected;
+    tick(true);
+  }
 
-    auto encoderClicked = encoder->getNewClick();
-    while (!encoderClicked) {
-      encoder->tick();
-      auto encoderUpdate = encoder->getDirection();
-      encoderClicked = encoder->getNewClick();
+public:
+  /**
+   * @brief called during the loop function
+   *
+   * @param forceRedraw if true everything should be redrawn
+   */
+  virtual void tick(const bool& forceRedraw) {
+    const InputEvent event = readInput();
 
-      // Update the backlight timeout
-      if (encoderClicked || (encoderUpdate != RotaryEncoder::Direction::NOROTATION)) {
-        if (!getBacklightTimeoutManager().delayTimeout()) {
-          encoderClicked = false;
-          continue;
-        }
+    // Update the backlight timeout
+    if (event != InputEvent::none) {
+      if (!getBacklightTimeoutManager().delayTimeout()) {
+        getBacklightTimeoutManager().tick(display);
+        display->present();
+        return;
       }
-      getBacklightTimeoutManager().tick(display);
+    }
+    getBacklightTimeoutManager().tick(display);
 
-      if (yesSelected && (encoderUpdate == RotaryEncoder::Direction::CLOCKWISE)) {
-        yesSelected = false;
-      }
-      else if (!yesSelected && (encoderUpdate == RotaryEncoder::Direction::COUNTERCLOCKWISE)) {
-        yesSelected = true;
-      }
+    if (event == InputEvent::select) {
+      close();
+      return;
+    }
+    else if (event == InputEvent::back) {
+      // leaving the dialog answers no
+      yesSelected = false;
+      close();
+      return;
+    }
+
+    if (yesSelected && (event == InputEvent::down)) {
+      yesSelected = false;
+    }
+    else if (!yesSelected && (event == InputEvent::up)) {
+      yesSelected = true;
+    }
 
-      if (yesSelected != lastDrawState) {
-        auto space = (numberOfColumns - 9) / 3;
-        if (yesSelected) {
-          display->setCursor(space, 3);
-          display->print(">YES<");
-          display->setCursor(2 * space + 6, 3);
-          display->print(" No ");
-        }
-        else {
-          display->setCursor(space, 3);
-          display->print(" YES ");
-          display->setCursor(2 * space + 6, 3);
-          display->print(">No<");
-        }
-        lastDrawState = yesSelected;
+    if (yesSelected != lastDrawState) {
+      // the buttons need 10 columns
+      const auto space = std::max((numberOfColumns - 9) / 3, 0);
+      if (yesSelected) {
+        display->setCursor(space, numberOfRows - 1);
+        display->print(">YES<");
+        display->setCursor(2 * space + 6, numberOfRows - 1);
+        display->print(" No ");
+      }
+      else {
+        display->setCursor(space, numberOfRows - 1);
+        display->print(" YES ");
+        display->setCursor(2 * space + 6, numberOfRows - 1);
+        display->print(">No<");
       }
-      delay(100);
+      lastDrawState = yesSelected;
     }
+    display->present();
   }
-
-protected:
-  /**
-   * @brief called during the loop function
-   *
-   * @param forceRedraw if true everything should be redrawn
-   */
-  virtual void tick(const bool& forceRedraw) {}
 };
-} // namespace lcd
\ No newline at end of file
+} // namespace lcd
@@ -8,7 +8,8 @@
 
 namespace lcd {
 /**
- * @brief Dialog with a yes and a no button
+ * @brief Dialog with a yes, a no and a back button. Needs a display with at
+ * least 15 columns.
  */
 class DialogYesNoBack : public DialogBase {
 public:
@@ -47,6 +48,25 @@ public:
     : DialogBase(display, "Yes/No/Back Dialog", encoder, text, numberOfColumns, numberOfRows)
     , selection(DialogResult::yes) {}
 
+public:
+  /**
+   * @brief Construct a new Dialog whose text is read from the current string
+   * table every time it is shown
+   *
+   * @param display pointer to the display instance
+   * @param encoder pointer to the encoder instance
+   * @param text number of the text in the string tables
+   * @param numberOfColumns number of display-columns
+   * @param numberOfRows number of display-rows
+   */
+  DialogYesNoBack(LiquidCrystal_PCF8574* display,
+                  RotaryEncoder* encoder,
+                  const TextId& text,
+                  const int& numberOfColumns,
+                  const int& numberOfRows)
+    : DialogBase(display, "Yes/No/Back Dialog", encoder, text, numberOfColumns, numberOfRows)
+    , selection(DialogResult::yes) {}
+
 public:
   /**
    * @brief Copy constructor - not available
@@ -64,17 +84,34 @@ public:
    * @brief Shows the dialog modal and after closing it activates the previous
    * view again
    *
-   * @param yesSelected if true yes is selected by default as soon as the the
+   * @param defaultSelection the option which is selected as soon as the
    * dialog is displayed
-   * @return true if yes was selected
+   * @return the selected option
    */
   DialogResult showModal(const DialogResult& defaultSelection) {
     this->selection = defaultSelection;
     lcd::ViewBase::activateView(this);
-    activatePreviousView();
+    runModal();
     return this->selection;
   }
 
+public:
+  /**
+   * @brief Shows the dialog without blocking. The current view must be ticked
+   * in the loop function. After closing the dialog the previous view is
+   * activated again.
+   *
+   * @param defaultSelection the option which is selected as soon as the
+   * dialog is displayed
+   * @return future which is ready as soon as the dialog is closed and which
+   * contains the selected option
+   */
+  Future<DialogResult> ask(const DialogResult& defaultSelection) {
+    this->selection = defaultSelection;
+    lcd::ViewBase::activateView(this);
+    return Future<DialogResult>(&closed, &this->selection);
+  }
+
 protected:
   /**
    * @brief called as soon as the view becomes active
@@ -82,78 +119,88 @@ protected:
   virtual void activate() {
     DialogBase::activate();
     lastDrawState = (DialogResult)((int)selection + 2);
+    tick(true);
+  }
 
-    auto encoderClicked = encoder->getNewClick();
-    while (!encoderClicked) {
-      auto encoderUpdate = encoder->getDirection();
-      encoderClicked = encoder->getNewClick();
-
-      // Update the backlight timeout
-      if (encoderClicked || (encoderUpdate != RotaryEncoder::Direction::NOROTATION)) {
-        if (!getBacklightTimeoutManager().delayTimeout()) {
-          encoderClicked = false;
-          continue;
-        }
+public:
+  /**
+   * @brief called during the loop function
+   *
+   * @param forceRedraw if true everything should be redrawn
+   */
+  virtual void tick(const bool& forceRedraw) {
+    const InputEvent event = readInput();
+
+    // Update the backlight timeout
+    if (event != InputEvent::none) {
+      if (!getBacklightTimeoutManager().delayTimeout()) {
+        getBacklightTimeoutManager().tick(display);
+        display->present();
+        return;
+      }
+    }
+    getBacklightTimeoutManager().tick(display);
+
+    if (event == InputEvent::select) {
+      close();
+      return;
+    }
+    else if (event == InputEvent::back) {
+      selection = DialogResult::back;
+      close();
+      return;
+    }
+
+    if (event == InputEvent::down) {
+      if (selection == DialogResult::yes) {
+        selection = DialogResult::no;
+      }
+      else if (selection == DialogResult::no) {
+        selection = DialogResult::back;
       }
-      getBacklightTimeoutManager().tick(display);
-
-      if (encoderUpdate == RotaryEncoder::Direction::CLOCKWISE) {
-        if (selection == DialogResult::yes) {
-          selection = DialogResult::no;
-        }
-        else if (selection == DialogResult::no) {
-          selection = DialogResult::back;
-        }
+    }
+    else if (event == InputEvent::up) {
+      if (selection == DialogResult::back) {
+        selection = DialogResult::no;
       }
-      else if (encoderUpdate == RotaryEncoder::Direction::COUNTERCLOCKWISE) {
-        if (selection == DialogResult::back) {
-          selection = DialogResult::no;
-        }
-        else if (selection == DialogResult::no) {
-          selection = DialogResult::yes;
-        }
+      else if (selection == DialogResult::no) {
+        selection = DialogResult::yes;
       }
+    }
 
-      if (selection != lastDrawState) {
-        switch (selection) {
-        case DialogResult::yes:
-          display->setCursor(1, 3);
-          display->print(">yes<");
-          display->setCursor(7, 3);
-          display->print(" no ");
-          display->setCursor(12, 3);
-          display->print(" back ");
-          break;
-        case DialogResult::no:
-          display->setCursor(1, 3);
-          display->print(" yes ");
-          display->setCursor(7, 3);
-          display->print(">no<");
-          display->setCursor(12, 3);
-          display->print(" back ");
-          break;
-        case DialogResult::back:
-          display->setCursor(1, 3);
-          display->print(" yes ");
-          display->setCursor(7, 3);
-          display->print(" no ");
-          display->setCursor(12, 3);
-          display->print(">back<");
-          break;
-        }
-
-        lastDrawState = selection;
+    if (selection != lastDrawState) {
+      // the buttons need 15 columns
+      const auto space = std::max((numberOfColumns - 15) / 4, 0);
+      switch (selection) {
+      case DialogResult::yes:
+        display->setCursor(space, numberOfRows - 1);
+        display->print(">yes<");
+        display->setCursor(2 * space + 5, numberOfRows - 1);
+        display->print(" no ");
+        display->setCursor(3 * space + 9, numberOfRows - 1);
+        display->print(" back ");
+        break;
+      case DialogResult::no:
+        display->setCursor(space, numberOfRows - 1);
+        display->print(" yes ");
+        display->setCursor(2 * space + 5, numberOfRows - 1);
+        display->print(">no<");
+        display->setCursor(3 * space + 9, numberOfRows - 1);
+        display->print(" back ");
+        break;
+      case DialogResult::back:
+        display->setCursor(space, numberOfRows - 1);
+        display->print(" yes ");
+        display->setCursor(2 * space + 5, numberOfRows - 1);
+        display->print(" no ");
+        display->setCursor(3 * space + 9, numberOfRows - 1);
+        display->print(">back<");
+        break;
       }
-      delay(100);
+
+      lastDrawState = selection;
     }
+    display->present();
   }
-
-protected:
-  /**
-   * @brief called during the loop function
-   *
-   * @param forceRedraw if true everything should be redrawn
-   */
-  virtual void tick(const bool& forceRedraw) {}
 };
-} // namespace lcd
\ No newline at end of file
+} // namespace lcd
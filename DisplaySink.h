@@ -0,0 +1,127 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <LiquidCrystal_PCF8574.h>
+
+namespace lcd {
+/**
+ * @brief Receiver of the changes which are sent by Frame::present
+ */
+class DisplaySink {
+public:
+  /**
+   * @brief Destroy the sink
+   */
+  virtual ~DisplaySink() {}
+
+public:
+  /**
+   * @brief Returns false if the sink cannot accept the passed number of
+   * operations right now. The frame keeps the changes and sends them during a
+   * later flush.
+   */
+  virtual bool canAccept(const size_t& operations) {
+    return true;
+  }
+
+public:
+  /**
+   * @brief Clears the display
+   */
+  virtual void clear() = 0;
+
+public:
+  /**
+   * @brief Writes a run of characters into one row
+   *
+   * @param column first display-column of the run
+   * @param row display-row of the run
+   * @param data the characters
+   * @param length number of characters
+   */
+  virtual void writeCells(const uint8_t& column, const uint8_t& row, const uint8_t* data, const uint8_t& length) = 0;
+
+public:
+  /**
+   * @brief Uploads the bitmap of a special character
+   *
+   * @param location number of the special character (0..7)
+   * @param charmap the 8 rows of the bitmap
+   */
+  virtual void createChar(const uint8_t& location, const uint8_t* charmap) = 0;
+
+public:
+  /**
+   * @brief Turns the backlight on or off
+   */
+  virtual void setBacklight(const bool& on) = 0;
+};
+
+/**
+ * @brief Sink writing directly to the LCD
+ */
+class LcdSink : public DisplaySink {
+protected:
+  /**
+   * @brief Pointer to the LCD instance
+   */
+  LiquidCrystal_PCF8574* lcd;
+
+public:
+  /**
+   * @brief Construct a new sink
+   *
+   * @param lcd pointer to the LCD instance
+   */
+  LcdSink(LiquidCrystal_PCF8574* lcd = nullptr)
+    : lcd(lcd) {}
+
+public:
+  /**
+   * @brief Sets the LCD to which the changes are written
+   */
+  void setDisplay(LiquidCrystal_PCF8574* newLcd) {
+    lcd = newLcd;
+  }
+
+public:
+  /**
+   * @brief Get the LCD to which the changes are written
+   */
+  LiquidCrystal_PCF8574* getDisplay() const {
+    return lcd;
+  }
+
+public:
+  virtual bool canAccept(const size_t& operations) {
+    return lcd != nullptr;
+  }
+
+public:
+  virtual void clear() {
+    lcd->clear();
+  }
+
+public:
+  virtual void writeCells(const uint8_t& column, const uint8_t& row, const uint8_t* data, const uint8_t& length) {
+    lcd->setCursor(column, row);
+    lcd->write(data, length);
+  }
+
+public:
+  virtual void createChar(const uint8_t& location, const uint8_t* charmap) {
+    byte bitmap[8];
+    std::copy(charmap, charmap + 8, bitmap);
+    lcd->createChar(location, bitmap);
+  }
+
+public:
+  virtual void setBacklight(const bool& on) {
+    lcd->setBacklight(on ? 1 : 0);
+  }
+};
+} // namespace lcd
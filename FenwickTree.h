@@ -0,0 +1,106 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+namespace lcd {
+/**
+ * @brief Binary indexed tree storing a count per element. Changing a count,
+ * calculating the sum of the first elements and finding the element at which
+ * a sum is reached take O(log n). Elements can be appended in O(log n).
+ */
+class FenwickTree {
+protected:
+  /**
+   * @brief Partial sums, tree[i] is the sum of the elements i - lowbit(i + 1)
+   * + 1 .. i
+   */
+  std::vector<int> tree;
+
+public:
+  /**
+   * @brief Number of elements
+   */
+  size_t size() const {
+    return tree.size();
+  }
+
+public:
+  /**
+   * @brief Removes all elements
+   */
+  void clear() {
+    tree.clear();
+  }
+
+public:
+  /**
+   * @brief Appends an element
+   */
+  void append(const int& value) {
+    // the new node covers its own value and the nodes below it
+    const size_t index = tree.size();
+    const size_t first = index + 1 - ((index + 1) & -(index + 1));
+    tree.push_back(value + prefixSum(index) - prefixSum(first));
+  }
+
+public:
+  /**
+   * @brief Adds a value to the count of an element
+   */
+  void add(const size_t& index, const int& delta) {
+    for (size_t i = index + 1; i <= tree.size(); i += i & -i) {
+      tree[i - 1] += delta;
+    }
+  }
+
+public:
+  /**
+   * @brief Sum of the counts of the first elements
+   *
+   * @param count number of elements to sum
+   */
+  int prefixSum(const size_t& count) const {
+    int sum = 0;
+    for (size_t i = count; i > 0; i -= i & -i) {
+      sum += tree[i - 1];
+    }
+    return sum;
+  }
+
+public:
+  /**
+   * @brief Sum of all counts
+   */
+  int total() const {
+    return prefixSum(tree.size());
+  }
+
+public:
+  /**
+   * @brief Returns the first element at which the prefix sum exceeds the
+   * passed value, e.g. the index of the n-th element with a count of 1 if
+   * all counts are 0 or 1.
+   *
+   * @return size() if the total is not larger than the value
+   */
+  size_t find(int value) const {
+    size_t position = 0;
+    size_t step = 1;
+    while (step * 2 <= tree.size()) {
+      step *= 2;
+    }
+    for (; step > 0; step /= 2) {
+      if ((position + step <= tree.size()) && (tree[position + step - 1] <= value)) {
+        position += step;
+        value -= tree[position - 1];
+      }
+    }
+    return position;
+  }
+};
+} // namespace lcd
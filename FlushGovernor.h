@@ -0,0 +1,210 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Clock.h"
+
+#include <Arduino.h>
+
+/**
+ * Maximum factor by which animations are slowed down while the display
+ * cannot keep up
+ */
+#ifndef LCD_GOVERNOR_MAX_SLOWDOWN
+#define LCD_GOVERNOR_MAX_SLOWDOWN 8
+#endif
+
+/**
+ * Time in milliseconds for which changes must stay pending before the display
+ * is considered saturated and animations are slowed down further
+ */
+#ifndef LCD_GOVERNOR_SATURATION_TIME
+#define LCD_GOVERNOR_SATURATION_TIME 100
+#endif
+
+/**
+ * Time in milliseconds without saturation after which the slowdown of
+ * animations is halved
+ */
+#ifndef LCD_GOVERNOR_RECOVERY_TIME
+#define LCD_GOVERNOR_RECOVERY_TIME 1000
+#endif
+
+namespace lcd {
+/**
+ * @brief Limits the time a single Frame::present spends writing to the
+ * display. The governor measures how long the display needs per transferred
+ * byte and stops a flush as soon as the next write would exceed the budget.
+ * The remaining changes are sent during the next loop iterations. While
+ * flushes cannot be completed the display is saturated and animations are
+ * slowed down.
+ *
+ * Example:
+ * @code
+ * // spend at most 2ms per loop iteration on the LCD
+ * lcd::ViewBase::getFrame().getGovernor().setBudget(2000);
+ * @endcode
+ */
+class FlushGovernor {
+protected:
+  /**
+   * @brief Maximum duration of a flush in microseconds, 0 if unlimited
+   */
+  unsigned long budget;
+
+protected:
+  /**
+   * @brief Measured duration of one transferred byte in 1/16 microseconds
+   */
+  unsigned long costPerByte;
+
+protected:
+  /**
+   * @brief micros value at the beginning of the current flush
+   */
+  uint32_t flushStart;
+
+protected:
+  /**
+   * @brief Number of writes during the current flush
+   */
+  uint8_t writes;
+
+protected:
+  /**
+   * @brief Factor by which animations are slowed down
+   */
+  uint8_t slowdown;
+
+protected:
+  /**
+   * @brief True if the last flush left changes pending
+   */
+  bool pending;
+
+protected:
+  /**
+   * @brief millis value at which changes started to stay pending or at which
+   * the slowdown was changed last
+   */
+  uint32_t lastChange;
+
+public:
+  /**
+   * @brief Construct a new governor without a budget
+   */
+  FlushGovernor()
+    : budget(0)
+    , costPerByte(16 * 100)
+    , flushStart(0)
+    , writes(0)
+    , slowdown(1)
+    , pending(false)
+    , lastChange(0) {}
+
+public:
+  /**
+   * @brief Sets the maximum duration of a flush in microseconds. 0 disables
+   * the limit. At least one write is done in every flush, so the display
+   * always makes progress.
+   */
+  void setBudget(const unsigned long& microseconds) {
+    budget = microseconds;
+  }
+
+public:
+  /**
+   * @brief Get the maximum duration of a flush in microseconds
+   */
+  unsigned long getBudget() const {
+    return budget;
+  }
+
+public:
+  /**
+   * @brief Get the measured throughput of the display
+   */
+  unsigned long getBytesPerSecond() const {
+    return 16000000UL / (costPerByte ? costPerByte : 1);
+  }
+
+public:
+  /**
+   * @brief Get the factor by which animations should be slowed down (1 if
+   * the display is not saturated)
+   */
+  uint8_t getAnimationSlowdown() const {
+    return slowdown;
+  }
+
+public:
+  /**
+   * @brief Must be called at the beginning of a flush
+   */
+  void beginFlush() {
+    flushStart = Clock::get().micros();
+    writes = 0;
+  }
+
+public:
+  /**
+   * @brief Returns true if a write of the passed number of bytes fits into
+   * the remaining budget of the current flush
+   */
+  bool allows(const size_t& bytes) const {
+    if ((budget == 0) || (writes == 0)) {
+      return true;
+    }
+    const uint32_t elapsed = Clock::get().micros() - flushStart;
+    return elapsed + bytes * costPerByte / 16 <= budget;
+  }
+
+public:
+  /**
+   * @brief Records the duration of a write to update the measured throughput
+   *
+   * @param bytes number of transferred bytes including commands
+   * @param start micros value before the write
+   */
+  void recordWrite(const size_t& bytes, const uint32_t& start) {
+    const unsigned long cost = (unsigned long)(Clock::get().micros() - start) * 16 / (bytes ? bytes : 1);
+    // exponential moving average with a weight of 1/8
+    costPerByte = costPerByte - costPerByte / 8 + cost / 8;
+    if (writes != 0xFF) {
+      writes++;
+    }
+  }
+
+public:
+  /**
+   * @brief Must be called at the end of a flush
+   *
+   * @param complete false if changes are left for the next flush
+   */
+  void endFlush(const bool& complete) {
+    const uint32_t now = Clock::get().millis();
+    if (!complete) {
+      if (!pending) {
+        pending = true;
+        lastChange = now;
+      }
+      else if ((now - lastChange >= LCD_GOVERNOR_SATURATION_TIME) && (slowdown < LCD_GOVERNOR_MAX_SLOWDOWN)) {
+        slowdown = slowdown * 2 < LCD_GOVERNOR_MAX_SLOWDOWN ? slowdown * 2 : LCD_GOVERNOR_MAX_SLOWDOWN;
+        lastChange = now;
+      }
+    }
+    else {
+      if (pending) {
+        pending = false;
+        lastChange = now;
+      }
+      else if ((slowdown > 1) && (now - lastChange >= LCD_GOVERNOR_RECOVERY_TIME)) {
+        slowdown /= 2;
+        lastChange = now;
+      }
+    }
+  }
+};
+} // namespace lcd
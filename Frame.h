@@ -0,0 +1,586 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Clock.h"
+#include "Config.h"
+#include "DisplaySink.h"
+#include "FlushGovernor.h"
+#include "Overlay.h"
+
+#include <Arduino.h>
+#include <LiquidCrystal_PCF8574.h>
+
+/**
+ * Two runs of changed cells in the same row which are separated by at most
+ * this number of unchanged cells are sent as one run. Rewriting a few
+ * unchanged cells is cheaper than an additional cursor command.
+ */
+#ifndef LCD_FRAME_MERGE_GAP
+#define LCD_FRAME_MERGE_GAP 2
+#endif
+
+namespace lcd {
+/**
+ * @brief Shadow of the display content. Views draw into the frame using the
+ * same functions as on the LCD. Overlays are composited on top of the drawn
+ * content and flush only sends the cells which differ from the content which
+ * is currently shown on the LCD.
+ */
+class Frame : public Print {
+protected:
+  /**
+   * @brief Sink used if the frame is flushed directly to the LCD
+   */
+  LcdSink lcdSink;
+
+protected:
+  /**
+   * @brief Receiver of the changes
+   */
+  DisplaySink* sink;
+
+protected:
+  /**
+   * @brief Number of display-columns
+   */
+  uint8_t numberOfColumns;
+
+protected:
+  /**
+   * @brief Number of display-rows
+   */
+  uint8_t numberOfRows;
+
+protected:
+  /**
+   * @brief Content drawn by the active view
+   */
+  uint8_t cells[LCD_FRAME_ROWS][LCD_FRAME_COLUMNS];
+
+protected:
+  /**
+   * @brief Content currently shown on the LCD
+   */
+  uint8_t shown[LCD_FRAME_ROWS][LCD_FRAME_COLUMNS];
+
+protected:
+  /**
+   * @brief If false the content of the LCD is unknown and must be cleared
+   * during the next flush
+   */
+  bool shownValid;
+
+protected:
+  /**
+   * @brief Bitmask of the rows which might differ from the LCD
+   */
+  uint8_t dirtyRows;
+
+protected:
+  /**
+   * @brief Column to which the next character is written, stops at 255
+   * which is always outside the display
+   */
+  uint8_t cursorColumn;
+
+protected:
+  /**
+   * @brief Row to which the next character is written
+   */
+  uint8_t cursorRow;
+
+protected:
+  /**
+   * @brief Number of characters which were written outside the display
+   */
+  uint16_t droppedCharacters;
+
+#if LCD_FEATURE_GLYPHS
+protected:
+  /**
+   * @brief Bitmaps of the special characters
+   */
+  uint8_t glyphs[8][8];
+
+protected:
+  /**
+   * @brief Bitmask of the special characters which must be uploaded
+   */
+  uint8_t dirtyGlyphs;
+
+protected:
+  /**
+   * @brief Bitmask of the special characters which are known to be stored in
+   * the LCD
+   */
+  uint8_t validGlyphs;
+
+protected:
+  /**
+   * @brief Bitmask of the special characters which were set by createChar
+   */
+  uint8_t definedGlyphs;
+#endif
+
+protected:
+  /**
+   * @brief Requested state of the backlight
+   */
+  bool backlight;
+
+protected:
+  /**
+   * @brief If true the backlight state must be sent
+   */
+  bool backlightDirty;
+
+protected:
+  /**
+   * @brief First registered overlay
+   */
+  Overlay* firstOverlay;
+
+protected:
+  /**
+   * @brief Limits the time spent in flush
+   */
+  FlushGovernor governor;
+
+public:
+  /**
+   * @brief Construct a new frame
+   */
+  Frame()
+    : sink(&lcdSink)
+    , numberOfColumns(LCD_FRAME_COLUMNS)
+    , numberOfRows(LCD_FRAME_ROWS)
+    , shownValid(false)
+    , dirtyRows(0)
+    , cursorColumn(0)
+    , cursorRow(0)
+    , droppedCharacters(0)
+#if LCD_FEATURE_GLYPHS
+    , dirtyGlyphs(0)
+    , validGlyphs(0)
+    , definedGlyphs(0)
+#endif
+    , backlight(true)
+    , backlightDirty(false)
+    , firstOverlay(nullptr) {
+    static_assert(LCD_FRAME_ROWS <= 8, "dirtyRows can only store 8 rows");
+    static_assert(LCD_FRAME_COLUMNS < 0xFF, "the cursor saturates at column 255");
+#if LCD_FEATURE_GLYPHS
+    for (auto& glyph : glyphs) {
+      std::fill_n(glyph, 8, 0);
+    }
+#endif
+    for (auto& row : cells) {
+      std::fill_n(row, LCD_FRAME_COLUMNS, ' ');
+    }
+  }
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  Frame(const Frame& other) = delete;
+
+public:
+  /**
+   * @brief Sets the LCD to which the frame is flushed
+   */
+  void setDisplay(LiquidCrystal_PCF8574* newLcd) {
+    if (lcdSink.getDisplay() != newLcd) {
+      lcdSink.setDisplay(newLcd);
+      invalidate();
+    }
+  }
+
+public:
+  /**
+   * @brief Get the LCD to which the frame is flushed
+   */
+  LiquidCrystal_PCF8574* getDisplay() const {
+    return lcdSink.getDisplay();
+  }
+
+public:
+  /**
+   * @brief Replaces the receiver of the changes, e.g. by a RenderPipeline.
+   * Passing nullptr flushes directly to the LCD again.
+   */
+  void setSink(DisplaySink* newSink) {
+    newSink = newSink ? newSink : &lcdSink;
+    if (sink != newSink) {
+      sink = newSink;
+      invalidate();
+    }
+  }
+
+public:
+  /**
+   * @brief Get the receiver of the changes
+   */
+  DisplaySink* getSink() const {
+    return sink;
+  }
+
+public:
+  /**
+   * @brief Get the governor limiting the time spent in flush
+   */
+  FlushGovernor& getGovernor() {
+    return governor;
+  }
+
+public:
+  /**
+   * @brief Sets the size of the display. Values larger than LCD_FRAME_COLUMNS
+   * and LCD_FRAME_ROWS are limited.
+   */
+  void setSize(const int& columns, const int& rows) {
+    numberOfColumns = columns < LCD_FRAME_COLUMNS ? columns : LCD_FRAME_COLUMNS;
+    numberOfRows = rows < LCD_FRAME_ROWS ? rows : LCD_FRAME_ROWS;
+  }
+
+public:
+  /**
+   * @brief Number of display-columns
+   */
+  uint8_t getNumberOfColumns() const {
+    return numberOfColumns;
+  }
+
+public:
+  /**
+   * @brief Number of display-rows
+   */
+  uint8_t getNumberOfRows() const {
+    return numberOfRows;
+  }
+
+public:
+  /**
+   * @brief Forgets what is shown on the LCD. The next flush clears the LCD and
+   * sends everything again, e.g. after the LCD was reinitialized.
+   */
+  void invalidate() {
+    shownValid = false;
+#if LCD_FEATURE_GLYPHS
+    validGlyphs = 0;
+    dirtyGlyphs = definedGlyphs;
+#endif
+    backlightDirty = true;
+    dirtyRows = 0xFF;
+  }
+
+public:
+  /**
+   * @brief Moves the cursor
+   */
+  void setCursor(const uint8_t& column, const uint8_t& row) {
+    cursorColumn = column;
+    cursorRow = row;
+  }
+
+public:
+  /**
+   * @brief Fills the frame with spaces and moves the cursor home
+   */
+  void clear() {
+    for (uint8_t row = 0; row < numberOfRows; row++) {
+      std::fill_n(cells[row], numberOfColumns, ' ');
+    }
+    dirtyRows = 0xFF;
+    setCursor(0, 0);
+  }
+
+public:
+  /**
+   * @brief Writes a character at the cursor position and advances the cursor.
+   * Characters outside the display are dropped.
+   */
+  virtual size_t write(uint8_t c) {
+    if ((cursorRow < numberOfRows) && (cursorColumn < numberOfColumns)) {
+      if (cells[cursorRow][cursorColumn] != c) {
+        cells[cursorRow][cursorColumn] = c;
+        dirtyRows |= 1 << cursorRow;
+      }
+    }
+    else {
+      droppedCharacters++;
+    }
+    // saturate, wrapping around would continue at the first column
+    if (cursorColumn < 0xFF) {
+      cursorColumn++;
+    }
+    return 1;
+  }
+
+public:
+  /**
+   * @brief Writes several characters
+   */
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      write(buffer[i]);
+    }
+    return size;
+  }
+
+  using Print::write;
+
+public:
+  /**
+   * @brief Returns the number of characters which were written outside the
+   * display. The LCD would show them in another row, so views must not write
+   * them. The counter wraps around.
+   */
+  uint16_t getDroppedCharacters() const {
+    return droppedCharacters;
+  }
+
+public:
+  /**
+   * @brief Returns the character drawn by the view at the passed position
+   */
+  uint8_t getCell(const uint8_t& column, const uint8_t& row) const {
+    return cells[row][column];
+  }
+
+public:
+  /**
+   * @brief Returns the character currently shown on the LCD at the passed
+   * position
+   */
+  uint8_t getShownCell(const uint8_t& column, const uint8_t& row) const {
+    return shown[row][column];
+  }
+
+public:
+  /**
+   * @brief Stores the bitmap of a special character. It is uploaded during
+   * the next flush if it differs from the bitmap stored in the LCD. Does
+   * nothing if LCD_FEATURE_GLYPHS is 0.
+   *
+   * @param location number of the special character (0..7)
+   * @param charmap the 8 rows of the bitmap
+   */
+  void createChar(uint8_t location, const uint8_t charmap[]) {
+#if LCD_FEATURE_GLYPHS
+    const uint8_t slot = location & 7;
+    if (!(definedGlyphs & (1 << slot)) || !std::equal(charmap, charmap + 8, glyphs[slot])) {
+      std::copy(charmap, charmap + 8, glyphs[slot]);
+      dirtyGlyphs |= 1 << slot;
+      definedGlyphs |= 1 << slot;
+    }
+#endif
+  }
+
+public:
+  /**
+   * @brief Turns the backlight on or off during the next flush
+   */
+  void setBacklight(const int& on) {
+    if (backlight != (on != 0)) {
+      backlight = on != 0;
+      backlightDirty = true;
+    }
+  }
+
+public:
+  /**
+   * @brief Registers an overlay which is drawn on top of the active view
+   */
+  void addOverlay(Overlay* overlay) {
+    overlay->nextOverlay = firstOverlay;
+    overlay->changed = true;
+    firstOverlay = overlay;
+  }
+
+public:
+  /**
+   * @brief Removes a registered overlay
+   */
+  void removeOverlay(Overlay* overlay) {
+    for (Overlay** it = &firstOverlay; *it; it = &(*it)->nextOverlay) {
+      if (*it == overlay) {
+        *it = overlay->nextOverlay;
+        overlay->nextOverlay = nullptr;
+        if (overlay->row < LCD_FRAME_ROWS) {
+          dirtyRows |= 1 << overlay->row;
+        }
+        return;
+      }
+    }
+  }
+
+public:
+  /**
+   * @brief Updates the overlays and sends all changes to the sink. If the sink
+   * cannot accept all changes, the remaining ones stay pending and are sent
+   * with the content which is current during the next flush. So intermediate
+   * states are skipped instead of being queued. The same happens if the
+   * budget of the governor is exhausted.
+   *
+   * Not named flush: Print declares a virtual void flush in the AVR, ESP8266
+   * and ESP32 cores.
+   *
+   * @return true if all changes were sent
+   */
+  bool present() {
+    governor.beginFlush();
+    const bool complete = flushChanges();
+    governor.endFlush(complete);
+    return complete;
+  }
+
+protected:
+  /**
+   * @brief Sends the changes until the sink or the governor stops accepting
+   * writes
+   *
+   * @return true if all changes were sent
+   */
+  bool flushChanges() {
+    // update overlays
+    const uint32_t now = Clock::get().millis();
+    for (Overlay* overlay = firstOverlay; overlay; overlay = overlay->nextOverlay) {
+      overlay->tick(now);
+      if (overlay->changed) {
+        overlay->changed = false;
+        if (overlay->row < LCD_FRAME_ROWS) {
+          dirtyRows |= 1 << overlay->row;
+        }
+      }
+    }
+
+#if LCD_FEATURE_GLYPHS
+    // upload special characters before they are used
+    for (uint8_t slot = 0; (slot < 8) && dirtyGlyphs; slot++) {
+      if (dirtyGlyphs & (1 << slot)) {
+        if (!canWrite(9)) {
+          return false;
+        }
+        const uint32_t start = Clock::get().micros();
+        sink->createChar(slot, glyphs[slot]);
+        governor.recordWrite(9, start);
+        validGlyphs |= 1 << slot;
+        dirtyGlyphs &= ~(1 << slot);
+      }
+    }
+#endif
+
+    if (backlightDirty) {
+      if (!canWrite(1)) {
+        return false;
+      }
+      const uint32_t start = Clock::get().micros();
+      sink->setBacklight(backlight);
+      governor.recordWrite(1, start);
+      backlightDirty = false;
+    }
+
+    if (!shownValid) {
+      if (!canWrite(1)) {
+        return false;
+      }
+      // not measured: clearing takes much longer than writing a byte
+      sink->clear();
+      for (auto& row : shown) {
+        std::fill_n(row, LCD_FRAME_COLUMNS, ' ');
+      }
+      shownValid = true;
+      dirtyRows = 0xFF;
+    }
+
+    for (uint8_t row = 0; row < numberOfRows; row++) {
+      if (dirtyRows & (1 << row)) {
+        if (!flushRow(row)) {
+          return false;
+        }
+        dirtyRows &= ~(1 << row);
+      }
+    }
+    dirtyRows = 0;
+    return true;
+  }
+
+protected:
+  /**
+   * @brief Returns true if the sink accepts a write and it fits into the
+   * budget of the governor
+   *
+   * @param bytes number of bytes transferred to the LCD including commands
+   */
+  bool canWrite(const size_t& bytes) {
+    return governor.allows(bytes) && sink->canAccept(1);
+  }
+
+protected:
+  /**
+   * @brief Composites the overlays on top of one row of the view
+   *
+   * @param row the row to composite
+   * @param composite receives numberOfColumns characters
+   */
+  void compositeRow(const uint8_t& row, uint8_t* composite) const {
+    std::copy(cells[row], cells[row] + numberOfColumns, composite);
+    for (const Overlay* overlay = firstOverlay; overlay; overlay = overlay->nextOverlay) {
+      if (overlay->visible && (overlay->row == row)) {
+        for (uint8_t i = 0; (i < overlay->width) && (overlay->column + i < numberOfColumns); i++) {
+          composite[overlay->column + i] = overlay->cells[i];
+        }
+      }
+    }
+  }
+
+protected:
+  /**
+   * @brief Sends the changed cells of one row to the sink
+   *
+   * @return false if the sink did not accept all runs of the row
+   */
+  bool flushRow(const uint8_t& row) {
+    uint8_t composite[LCD_FRAME_COLUMNS];
+    compositeRow(row, composite);
+
+    uint8_t column = 0;
+    while (column < numberOfColumns) {
+      // search the first changed cell
+      while ((column < numberOfColumns) && (composite[column] == shown[row][column])) {
+        column++;
+      }
+      if (column == numberOfColumns) {
+        break;
+      }
+
+      // search the end of the run including small gaps of unchanged cells
+      uint8_t end = column + 1;
+      uint8_t lastChanged = column;
+      while ((end < numberOfColumns) && (end - lastChanged <= LCD_FRAME_MERGE_GAP + 1)) {
+        if (composite[end] != shown[row][end]) {
+          lastChanged = end;
+        }
+        end++;
+      }
+
+      const uint8_t length = lastChanged + 1 - column;
+      if (!canWrite(length + 1)) {
+        return false;
+      }
+      const uint32_t start = Clock::get().micros();
+      sink->writeCells(column, row, composite + column, length);
+      governor.recordWrite(length + 1, start);
+      std::copy(composite + column, composite + lastChanged + 1, shown[row] + column);
+      column = lastChanged + 1;
+    }
+    return true;
+  }
+};
+
+LCD_ASSERT_SIZE(Frame, LCD_BUDGET_FRAME);
+} // namespace lcd
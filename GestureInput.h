@@ -0,0 +1,351 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Clock.h"
+#include "InputManager.h"
+
+#include <Arduino.h>
+#include <RotaryEncoder.h>
+
+/**
+ * Number of switch edges which can be captured between two polls
+ */
+#ifndef LCD_GESTURE_EDGE_BUFFER_SIZE
+#define LCD_GESTURE_EDGE_BUFFER_SIZE 16
+#endif
+
+/**
+ * Attribute of functions called from interrupt service routines
+ */
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+#define LCD_ISR_ATTR IRAM_ATTR
+#else
+#define LCD_ISR_ATTR
+#endif
+
+namespace lcd {
+/**
+ * @brief Recognizes click, long press, double click and press-and-turn of a
+ * rotary encoder. The edges of the switch are captured with their timestamps
+ * in the interrupt service routine, so the recognition does not depend on how
+ * often the views are ticked. Only the rotation is read from the encoder
+ * library.
+ *
+ * Double clicks are disabled by default since they delay every single click
+ * by the double click time.
+ *
+ * Example:
+ * @code
+ * lcd::GestureInputSource gestures(&encoder, ENCODER_SWITCH);
+ *
+ * void ICACHE_RAM_ATTR encoderInterrupt(void) {
+ *   encoder.tick();
+ *   gestures.captureSwitch();
+ * }
+ *
+ * void setup() {
+ *   ...
+ *   lcd::ViewBase::getInput().addEncoderSource(&gestures, &encoder);
+ * }
+ * @endcode
+ */
+class GestureInputSource : public InputSource {
+protected:
+  /**
+   * @brief pointer to the encoder instance
+   */
+  RotaryEncoder* encoder;
+
+protected:
+  /**
+   * @brief The pin of the switch
+   */
+  const uint8_t pin;
+
+protected:
+  /**
+   * @brief If true the pin reads LOW while the switch is pressed
+   */
+  const bool activeLow;
+
+protected:
+  /**
+   * @brief millis values of the captured edges
+   */
+  volatile uint32_t edgeTimes[LCD_GESTURE_EDGE_BUFFER_SIZE];
+
+protected:
+  /**
+   * @brief States of the switch after the captured edges
+   */
+  volatile bool edgeStates[LCD_GESTURE_EDGE_BUFFER_SIZE];
+
+protected:
+  /**
+   * @brief Index of the oldest captured edge, only written by poll
+   */
+  volatile uint8_t edgeHead;
+
+protected:
+  /**
+   * @brief Index of the next free slot, only written by captureSwitch
+   */
+  volatile uint8_t edgeTail;
+
+protected:
+  /**
+   * @brief State of the switch when captureSwitch was called the last time
+   */
+  volatile bool capturedState;
+
+protected:
+  /**
+   * @brief Minimum time in milliseconds a state must be stable to be accepted
+   */
+  unsigned long debounceTime;
+
+protected:
+  /**
+   * @brief Time in milliseconds after which a held switch is a long press
+   */
+  unsigned long longPressTime;
+
+protected:
+  /**
+   * @brief Maximum time in milliseconds between the end of the first and the
+   * beginning of the second click of a double click, 0 to disable
+   */
+  unsigned long doubleClickTime;
+
+protected:
+  /**
+   * @brief Debounced state of the switch
+   */
+  bool pressed;
+
+protected:
+  /**
+   * @brief millis value at which the switch was pressed
+   */
+  uint32_t pressTime;
+
+protected:
+  /**
+   * @brief True if the current press already generated an event (long press
+   * or press-and-turn) and must not generate a click
+   */
+  bool pressConsumed;
+
+protected:
+  /**
+   * @brief True if a click waits for a possible second click
+   */
+  bool clickPending;
+
+protected:
+  /**
+   * @brief millis value at which the pending click ended
+   */
+  uint32_t clickTime;
+
+public:
+  /**
+   * @brief Construct a new source
+   *
+   * @param encoder pointer to the encoder instance
+   * @param pin the pin of the switch
+   * @param activeLow if true the pin reads LOW while the switch is pressed
+   */
+  GestureInputSource(RotaryEncoder* encoder, const uint8_t& pin, const bool& activeLow = true)
+    : encoder(encoder)
+    , pin(pin)
+    , activeLow(activeLow)
+    , edgeHead(0)
+    , edgeTail(0)
+    , capturedState(false)
+    , debounceTime(10)
+    , longPressTime(800)
+    , doubleClickTime(0)
+    , pressed(false)
+    , pressTime(0)
+    , pressConsumed(false)
+    , clickPending(false)
+    , clickTime(0) {}
+
+public:
+  /**
+   * @brief Reads the switch and stores the time if its state changed. Must be
+   * called in the interrupt service routine of the switch pin.
+   */
+  void LCD_ISR_ATTR captureSwitch() {
+    captureSwitch((digitalRead(pin) == LOW) == activeLow);
+  }
+
+public:
+  /**
+   * @brief Stores the time if the state of the switch changed. Can be used
+   * if the switch is not read by digitalRead.
+   *
+   * @param state true if the switch is pressed
+   */
+  void LCD_ISR_ATTR captureSwitch(const bool& state) {
+    // the installed Clock may not be callable from interrupts
+    captureSwitch(state, millis());
+  }
+
+public:
+  /**
+   * @brief Stores the passed time if the state of the switch changed, e.g.
+   * the time of a SimulatedClock
+   *
+   * @param state true if the switch is pressed
+   * @param time millis value of the change
+   */
+  void LCD_ISR_ATTR captureSwitch(const bool& state, const uint32_t& time) {
+    if (state == capturedState) {
+      return;
+    }
+    capturedState = state;
+    const uint8_t next = (edgeTail + 1) % LCD_GESTURE_EDGE_BUFFER_SIZE;
+    if (next != edgeHead) {
+      edgeTimes[edgeTail] = time;
+      edgeStates[edgeTail] = state;
+      edgeTail = next;
+    }
+  }
+
+public:
+  /**
+   * @brief Sets the minimum time in milliseconds a state of the switch must
+   * be stable
+   */
+  void setDebounceTime(const unsigned long& milliseconds) {
+    debounceTime = milliseconds;
+  }
+
+public:
+  /**
+   * @brief Sets the time in milliseconds after which a held switch is a long
+   * press
+   */
+  void setLongPressTime(const unsigned long& milliseconds) {
+    longPressTime = milliseconds;
+  }
+
+public:
+  /**
+   * @brief Sets the maximum time in milliseconds between two clicks of a
+   * double click. 0 disables double clicks.
+   */
+  void setDoubleClickTime(const unsigned long& milliseconds) {
+    doubleClickTime = milliseconds;
+  }
+
+public:
+  virtual void poll(InputQueue& queue) {
+    const uint32_t now = Clock::get().millis();
+
+    // An edge is accepted if the state after it was stable for debounceTime,
+    // i.e. the next edge came later or did not come yet.
+    while (edgeHead != edgeTail) {
+      const uint8_t next = (edgeHead + 1) % LCD_GESTURE_EDGE_BUFFER_SIZE;
+      const uint32_t time = edgeTimes[edgeHead];
+      const bool state = edgeStates[edgeHead];
+      const bool hasNext = next != edgeTail;
+      if (!hasNext && (now - time < debounceTime)) {
+        break;
+      }
+      if (!hasNext || (edgeTimes[next] - time >= debounceTime)) {
+        if (state != pressed) {
+          switchChanged(queue, state, time);
+        }
+      }
+      edgeHead = next;
+    }
+
+    // a click without a second click in time
+    if (clickPending && !pressed && (now - clickTime > doubleClickTime)) {
+      clickPending = false;
+      queue.push(InputEvent::select);
+    }
+
+    // a held switch is reported without waiting for the release
+    if (pressed && !pressConsumed && (now - pressTime >= longPressTime)) {
+      flushPendingClick(queue);
+      pressConsumed = true;
+      queue.push(InputEvent::longPress);
+    }
+
+    // discard the clicks detected by the encoder library
+    encoder->getNewClick();
+    const auto direction = encoder->getDirection();
+    if (direction != RotaryEncoder::Direction::NOROTATION) {
+      const bool clockwise = direction == RotaryEncoder::Direction::CLOCKWISE;
+      if (pressed) {
+        flushPendingClick(queue);
+        pressConsumed = true;
+        queue.push(clockwise ? InputEvent::pressTurnDown : InputEvent::pressTurnUp);
+      }
+      else {
+        flushPendingClick(queue);
+        queue.push(clockwise ? InputEvent::down : InputEvent::up);
+      }
+    }
+  }
+
+protected:
+  /**
+   * @brief Handles an accepted change of the switch
+   *
+   * @param queue receives the generated events
+   * @param state true if the switch was pressed
+   * @param time millis value of the change
+   */
+  void switchChanged(InputQueue& queue, const bool& state, const uint32_t& time) {
+    pressed = state;
+    if (pressed) {
+      // a pending click which is not followed in time is a single click
+      if (clickPending && (time - clickTime > doubleClickTime)) {
+        flushPendingClick(queue);
+      }
+      pressTime = time;
+      pressConsumed = false;
+      return;
+    }
+
+    if (pressConsumed) {
+      return;
+    }
+    if (time - pressTime >= longPressTime) {
+      // released before poll noticed the long press
+      flushPendingClick(queue);
+      queue.push(InputEvent::longPress);
+    }
+    else if (clickPending) {
+      clickPending = false;
+      queue.push(InputEvent::doubleClick);
+    }
+    else if (doubleClickTime == 0) {
+      queue.push(InputEvent::select);
+    }
+    else {
+      clickPending = true;
+      clickTime = time;
+    }
+  }
+
+protected:
+  /**
+   * @brief Reports a pending click as single click
+   */
+  void flushPendingClick(InputQueue& queue) {
+    if (clickPending) {
+      clickPending = false;
+      queue.push(InputEvent::select);
+    }
+  }
+};
+} // namespace lcd
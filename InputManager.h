@@ -0,0 +1,532 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Clock.h"
+#include "RingBuffer.h"
+
+#include <Arduino.h>
+#include <RotaryEncoder.h>
+
+/**
+ * Number of input events which can be queued
+ */
+#ifndef LCD_INPUT_QUEUE_SIZE
+#define LCD_INPUT_QUEUE_SIZE 8
+#endif
+
+/**
+ * Number of encoders which can be registered by the views
+ */
+#ifndef LCD_INPUT_MAX_ENCODERS
+#define LCD_INPUT_MAX_ENCODERS 2
+#endif
+
+namespace lcd {
+/**
+ * @brief Normalized input events consumed by the views
+ */
+enum class InputEvent : uint8_t {
+  /**
+   * @brief no event available
+   */
+  none,
+  /**
+   * @brief previous item or smaller value (counterclockwise rotation)
+   */
+  up,
+  /**
+   * @brief next item or larger value (clockwise rotation)
+   */
+  down,
+  /**
+   * @brief confirm the current item (click)
+   */
+  select,
+  /**
+   * @brief leave the current view
+   */
+  back,
+  /**
+   * @brief button was held down
+   */
+  longPress,
+  /**
+   * @brief button was clicked twice
+   */
+  doubleClick,
+  /**
+   * @brief counterclockwise rotation while the button is held down
+   */
+  pressTurnUp,
+  /**
+   * @brief clockwise rotation while the button is held down
+   */
+  pressTurnDown
+};
+
+/**
+ * @brief Queue of the input events
+ */
+using InputQueue = RingBuffer<InputEvent, LCD_INPUT_QUEUE_SIZE>;
+
+/**
+ * @brief Base class for devices generating input events
+ */
+class InputSource {
+  friend class InputManager;
+
+protected:
+  /**
+   * @brief Next registered source
+   */
+  InputSource* nextSource;
+
+public:
+  /**
+   * @brief Construct a new source
+   */
+  InputSource()
+    : nextSource(nullptr) {}
+
+public:
+  /**
+   * @brief Destroy the source
+   */
+  virtual ~InputSource() {}
+
+public:
+  /**
+   * @brief Adds the events which occurred since the last call to the queue
+   */
+  virtual void poll(InputQueue& queue) = 0;
+};
+
+/**
+ * @brief Generates up, down and select from a rotary encoder
+ */
+class EncoderInputSource : public InputSource {
+protected:
+  /**
+   * @brief pointer to the encoder instance
+   */
+  RotaryEncoder* encoder;
+
+public:
+  /**
+   * @brief Construct a new source
+   *
+   * @param encoder pointer to the encoder instance
+   */
+  EncoderInputSource(RotaryEncoder* encoder = nullptr)
+    : encoder(encoder) {}
+
+public:
+  /**
+   * @brief Get the encoder
+   */
+  RotaryEncoder* getEncoder() const {
+    return encoder;
+  }
+
+public:
+  /**
+   * @brief Sets the encoder
+   */
+  void setEncoder(RotaryEncoder* newEncoder) {
+    encoder = newEncoder;
+  }
+
+public:
+  virtual void poll(InputQueue& queue) {
+    if (!encoder) {
+      return;
+    }
+    auto direction = encoder->getDirection();
+    if (direction == RotaryEncoder::Direction::CLOCKWISE) {
+      queue.push(InputEvent::down);
+    }
+    else if (direction == RotaryEncoder::Direction::COUNTERCLOCKWISE) {
+      queue.push(InputEvent::up);
+    }
+    if (encoder->getNewClick()) {
+      queue.push(InputEvent::select);
+    }
+  }
+};
+
+/**
+ * @brief Generates events from a push button connected to a digital pin,
+ * e.g. a separate back button
+ */
+class ButtonInputSource : public InputSource {
+protected:
+  /**
+   * @brief The pin of the button
+   */
+  const uint8_t pin;
+
+protected:
+  /**
+   * @brief Event generated when the button is released
+   */
+  const InputEvent event;
+
+protected:
+  /**
+   * @brief Event generated when the button is held down for longPressTime
+   */
+  const InputEvent longPressEvent;
+
+protected:
+  /**
+   * @brief If true the pin reads LOW while the button is pressed
+   */
+  const bool activeLow;
+
+protected:
+  /**
+   * @brief Time in milliseconds after which a held button generates
+   * longPressEvent
+   */
+  unsigned long longPressTime;
+
+protected:
+  /**
+   * @brief Debounced state of the button
+   */
+  bool pressed;
+
+protected:
+  /**
+   * @brief True if the long press of the current press was reported
+   */
+  bool longPressReported;
+
+protected:
+  /**
+   * @brief millis value of the last change of the debounced state
+   */
+  uint32_t lastChange;
+
+public:
+  /**
+   * @brief Construct a new source. The pin must be configured by the caller.
+   *
+   * @param pin the pin of the button
+   * @param event event generated when the button is released
+   * @param longPressEvent event generated when the button is held down,
+   * InputEvent::none to disable
+   * @param activeLow if true the pin reads LOW while the button is pressed
+   */
+  ButtonInputSource(const uint8_t& pin,
+                    const InputEvent& event = InputEvent::back,
+                    const InputEvent& longPressEvent = InputEvent::longPress,
+                    const bool& activeLow = true)
+    : pin(pin)
+    , event(event)
+    , longPressEvent(longPressEvent)
+    , activeLow(activeLow)
+    , longPressTime(800)
+    , pressed(false)
+    , longPressReported(false)
+    , lastChange(0) {}
+
+public:
+  /**
+   * @brief Sets the time in milliseconds after which a held button generates
+   * the long press event
+   */
+  void setLongPressTime(const unsigned long& milliseconds) {
+    longPressTime = milliseconds;
+  }
+
+public:
+  virtual void poll(InputQueue& queue) {
+    const uint32_t now = Clock::get().millis();
+    const bool current = (digitalRead(pin) == LOW) == activeLow;
+
+    // debounce
+    if ((current != pressed) && (now - lastChange >= 20)) {
+      pressed = current;
+      lastChange = now;
+      if (!pressed && !longPressReported) {
+        queue.push(event);
+      }
+      longPressReported = false;
+    }
+    else if (pressed && !longPressReported && (longPressEvent != InputEvent::none) &&
+             (now - lastChange >= longPressTime)) {
+      queue.push(longPressEvent);
+      longPressReported = true;
+    }
+  }
+};
+
+/**
+ * @brief Generates events from keys received over a stream, e.g. Serial.
+ * Supported keys are the arrow keys, w/k (up), s/j (down), enter/space
+ * (select), backspace/b (back), l (long press), d (double click) and page
+ * up/down (press and turn).
+ */
+class SerialInputSource : public InputSource {
+protected:
+  /**
+   * @brief Stream from which the keys are read
+   */
+  Stream* stream;
+
+protected:
+  /**
+   * @brief State of the parser of escape sequences, 0 outside of a sequence
+   */
+  uint8_t escapeState;
+
+public:
+  /**
+   * @brief Construct a new source
+   *
+   * @param stream stream from which the keys are read
+   */
+  SerialInputSource(Stream* stream)
+    : stream(stream)
+    , escapeState(0) {}
+
+public:
+  virtual void poll(InputQueue& queue) {
+    while (stream->available() > 0) {
+      const int key = stream->read();
+
+      // arrow keys are sent as ESC [ A..D, page up/down as ESC [ 5/6 ~
+      if (escapeState == 1) {
+        escapeState = key == '[' ? 2 : 0;
+        continue;
+      }
+      else if (escapeState >= 3) {
+        if (key == '~') {
+          queue.push(escapeState == 3 ? InputEvent::pressTurnUp : InputEvent::pressTurnDown);
+        }
+        escapeState = 0;
+        continue;
+      }
+      else if (escapeState == 2) {
+        escapeState = 0;
+        switch (key) {
+        case '5':
+          escapeState = 3;
+          break;
+        case '6':
+          escapeState = 4;
+          break;
+        case 'A':
+          queue.push(InputEvent::up);
+          break;
+        case 'B':
+          queue.push(InputEvent::down);
+          break;
+        case 'C':
+          queue.push(InputEvent::select);
+          break;
+        case 'D':
+          queue.push(InputEvent::back);
+          break;
+        }
+        continue;
+      }
+
+      switch (key) {
+      case 0x1B:
+        escapeState = 1;
+        break;
+      case 'w':
+      case 'k':
+        queue.push(InputEvent::up);
+        break;
+      case 's':
+      case 'j':
+        queue.push(InputEvent::down);
+        break;
+      case '\r':
+      case '\n':
+      case ' ':
+        queue.push(InputEvent::select);
+        break;
+      case 'b':
+      case 0x08:
+      case 0x7F:
+        queue.push(InputEvent::back);
+        break;
+      case 'l':
+        queue.push(InputEvent::longPress);
+        break;
+      case 'd':
+        queue.push(InputEvent::doubleClick);
+        break;
+      }
+    }
+  }
+};
+
+/**
+ * @brief Merges the events of all registered sources into one queue. The
+ * encoders passed to the views are registered automatically. Additional
+ * sources, e.g. buttons, can be added using addSource and events can be
+ * injected, e.g. by tests.
+ */
+class InputManager {
+protected:
+  /**
+   * @brief First registered source
+   */
+  InputSource* firstSource;
+
+protected:
+  /**
+   * @brief Sources of the encoders passed to the views
+   */
+  EncoderInputSource encoders[LCD_INPUT_MAX_ENCODERS];
+
+protected:
+  /**
+   * @brief The queued events
+   */
+  InputQueue queue;
+
+public:
+  /**
+   * @brief Construct a new manager
+   */
+  InputManager()
+    : firstSource(nullptr) {}
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  InputManager(const InputManager& other) = delete;
+
+public:
+  /**
+   * @brief Registers a source
+   */
+  void addSource(InputSource* source) {
+    source->nextSource = firstSource;
+    firstSource = source;
+  }
+
+public:
+  /**
+   * @brief Removes a registered source
+   */
+  void removeSource(InputSource* source) {
+    for (InputSource** it = &firstSource; *it; it = &(*it)->nextSource) {
+      if (*it == source) {
+        *it = source->nextSource;
+        source->nextSource = nullptr;
+        return;
+      }
+    }
+  }
+
+public:
+  /**
+   * @brief Registers an encoder if it is not registered yet
+   */
+  void useEncoder(RotaryEncoder* encoder) {
+    registerEncoder(encoder, true);
+  }
+
+public:
+  /**
+   * @brief Registers a source which reads the passed encoder itself, e.g. a
+   * GestureInputSource. The events of the encoder are no longer generated
+   * by the views' default source.
+   */
+  void addEncoderSource(InputSource* source, RotaryEncoder* encoder) {
+    registerEncoder(encoder, false);
+    addSource(source);
+  }
+
+public:
+  /**
+   * @brief Adds an event to the queue as if it was generated by a source.
+   *
+   * @return false if the queue is full
+   */
+  bool inject(const InputEvent& event) {
+    return queue.push(event);
+  }
+
+public:
+  /**
+   * @brief Polls all sources
+   */
+  void poll() {
+    for (InputSource* source = firstSource; source; source = source->nextSource) {
+      source->poll(queue);
+    }
+  }
+
+public:
+  /**
+   * @brief Polls all sources and returns the oldest event
+   *
+   * @return InputEvent::none if no event is available
+   */
+  InputEvent getEvent() {
+    poll();
+    InputEvent event = InputEvent::none;
+    queue.pop(event);
+    return event;
+  }
+
+public:
+  /**
+   * @brief Drops all pending events, e.g. the click which opened a dialog
+   */
+  void discard() {
+    poll();
+    queue.clear();
+  }
+
+protected:
+  /**
+   * @brief Assigns an encoder to one of the default sources
+   *
+   * @param encoder the encoder
+   * @param enabled if false the encoder is read by another source and the
+   * default source is not polled
+   */
+  void registerEncoder(RotaryEncoder* encoder, const bool& enabled) {
+    if (!encoder) {
+      return;
+    }
+    EncoderInputSource* slot = nullptr;
+    for (auto& source : encoders) {
+      if (source.getEncoder() == encoder) {
+        slot = &source;
+        break;
+      }
+      else if (!slot && !source.getEncoder()) {
+        slot = &source;
+      }
+    }
+    if (!slot) {
+      return;
+    }
+    if (slot->getEncoder() == encoder) {
+      // a disabled encoder is not enabled again by the views
+      if (!enabled) {
+        removeSource(slot);
+      }
+      return;
+    }
+    slot->setEncoder(encoder);
+    if (enabled) {
+      addSource(slot);
+    }
+  }
+};
+} // namespace lcd
@@ -0,0 +1,301 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Config.h"
+#include "RingBuffer.h"
+
+#include <Arduino.h>
+#include <initializer_list>
+
+#define LCD_LOG_LEVEL_NONE    0
+#define LCD_LOG_LEVEL_ERROR   1
+#define LCD_LOG_LEVEL_WARNING 2
+#define LCD_LOG_LEVEL_INFO    3
+#define LCD_LOG_LEVEL_DEBUG   4
+
+/**
+ * Minimum level of messages which are compiled into the binary. Messages with
+ * a higher level are removed by the preprocessor including the evaluation of
+ * their arguments. Release builds (NDEBUG) and LCD_FEATURE_LOGGING 0 strip
+ * everything.
+ */
+#if !LCD_FEATURE_LOGGING
+#undef LCD_LOG_LEVEL
+#define LCD_LOG_LEVEL LCD_LOG_LEVEL_NONE
+#endif
+#ifndef LCD_LOG_LEVEL
+#ifdef NDEBUG
+#define LCD_LOG_LEVEL LCD_LOG_LEVEL_NONE
+#else
+#define LCD_LOG_LEVEL LCD_LOG_LEVEL_INFO
+#endif
+#endif
+
+/**
+ * Size of the RAM buffer in bytes in which messages are stored until they are
+ * drained by lcd::Log::flush.
+ */
+#ifndef LCD_LOG_BUFFER_SIZE
+#define LCD_LOG_BUFFER_SIZE 256
+#endif
+
+/**
+ * Number of bytes lcd::Log::flush writes per call if the output does not
+ * report its free transmit buffer. Print::availableForWrite returns 0 unless
+ * a stream overrides it.
+ */
+#ifndef LCD_LOG_FLUSH_CHUNK
+#define LCD_LOG_FLUSH_CHUNK 16
+#endif
+
+#if LCD_LOG_LEVEL >= LCD_LOG_LEVEL_ERROR
+#define LCD_LOG_ERROR(...) lcd::Log::getInstance().write(lcd::Log::Level::error, {__VA_ARGS__})
+#else
+#define LCD_LOG_ERROR(...) \
+  do {                     \
+  } while (0)
+#endif
+
+#if LCD_LOG_LEVEL >= LCD_LOG_LEVEL_WARNING
+#define LCD_LOG_WARNING(...) lcd::Log::getInstance().write(lcd::Log::Level::warning, {__VA_ARGS__})
+#else
+#define LCD_LOG_WARNING(...) \
+  do {                       \
+  } while (0)
+#endif
+
+#if LCD_LOG_LEVEL >= LCD_LOG_LEVEL_INFO
+#define LCD_LOG_INFO(...) lcd::Log::getInstance().write(lcd::Log::Level::info, {__VA_ARGS__})
+#else
+#define LCD_LOG_INFO(...) \
+  do {                    \
+  } while (0)
+#endif
+
+#if LCD_LOG_LEVEL >= LCD_LOG_LEVEL_DEBUG
+#define LCD_LOG_DEBUG(...) lcd::Log::getInstance().write(lcd::Log::Level::debug, {__VA_ARGS__})
+#else
+#define LCD_LOG_DEBUG(...) \
+  do {                     \
+  } while (0)
+#endif
+
+namespace lcd {
+/**
+ * @brief Levelled logging into a RAM ring buffer. Writing a message never
+ * blocks, the buffer is drained by calling flush from the loop function.
+ */
+class Log {
+public:
+  /**
+   * @brief Severity of a message
+   */
+  enum class Level { error = LCD_LOG_LEVEL_ERROR, warning, info, debug };
+
+public:
+  /**
+   * @brief One part of a log message. Numbers are formatted without using the
+   * heap, strings are referenced and not copied.
+   */
+  class Part {
+  protected:
+    /**
+     * @brief The referenced text
+     */
+    const char* text;
+
+  protected:
+    /**
+     * @brief Storage for formatted numbers
+     */
+    char number[12];
+
+  public:
+    /**
+     * @brief Construct a part referencing a zero terminated string
+     */
+    Part(const char* text)
+      : text(text ? text : "") {}
+
+  public:
+    /**
+     * @brief Construct a part referencing the content of a String
+     */
+    Part(const String& text)
+      : text(text.c_str()) {}
+
+  public:
+    /**
+     * @brief Construct a part from a signed number
+     */
+    Part(const long& value) {
+      unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+      char* start = format(magnitude);
+      if (value < 0) {
+        *--start = '-';
+      }
+      text = start;
+    }
+
+  public:
+    /**
+     * @brief Construct a part from an unsigned number
+     */
+    Part(const unsigned long& value)
+      : text(format(value)) {}
+
+  public:
+    /**
+     * @brief Construct a part from a signed number
+     */
+    Part(const int& value)
+      : Part((long)value) {}
+
+  public:
+    /**
+     * @brief Construct a part from an unsigned number
+     */
+    Part(const unsigned int& value)
+      : Part((unsigned long)value) {}
+
+  public:
+    /**
+     * @brief Copy constructor. Must be implemented since text might point into
+     * number.
+     */
+    Part(const Part& other)
+      : text(other.text) {
+      if ((other.text >= other.number) && (other.text < other.number + sizeof(number))) {
+        std::copy(other.number, other.number + sizeof(number), number);
+        text = number + (other.text - other.number);
+      }
+    }
+
+  public:
+    /**
+     * @brief Returns the zero terminated text of the part
+     */
+    const char* c_str() const {
+      return text;
+    }
+
+  protected:
+    /**
+     * @brief Formats a number right aligned into the number buffer
+     *
+     * @return pointer to the first digit
+     */
+    char* format(unsigned long value) {
+      char* start = number + sizeof(number) - 1;
+      *start = '\0';
+      do {
+        *--start = '0' + (value % 10);
+        value /= 10;
+      } while (value != 0);
+      return start;
+    }
+  };
+
+protected:
+  /**
+   * @brief Buffer containing the messages which are not yet drained
+   */
+  RingBuffer<char, LCD_LOG_BUFFER_SIZE> buffer;
+
+protected:
+  /**
+   * @brief Number of messages dropped because the buffer was full
+   */
+  unsigned long droppedMessages;
+
+protected:
+  /**
+   * @brief Construct the log. Use getInstance to access the singleton.
+   */
+  Log()
+    : droppedMessages(0) {}
+
+public:
+  /**
+   * @brief Returns the singleton of the log
+   */
+  static Log& getInstance() {
+    static Log log;
+    return log;
+  }
+
+public:
+  /**
+   * @brief Appends a message to the buffer. If the complete message does not
+   * fit into the buffer it is dropped.
+   *
+   * @param level severity of the message
+   * @param parts the parts of the message which are concatenated
+   */
+  void write(const Level& level, std::initializer_list<Part> parts) {
+    static const char prefixes[] = {'E', 'W', 'I', 'D'};
+
+    size_t length = 3; // prefix, space and newline
+    for (const auto& part : parts) {
+      length += strlen(part.c_str());
+    }
+    if (length > buffer.free()) {
+      droppedMessages++;
+      return;
+    }
+
+    buffer.push(prefixes[(int)level - (int)Level::error]);
+    buffer.push(' ');
+    for (const auto& part : parts) {
+      for (const char* c = part.c_str(); *c; c++) {
+        buffer.push(*c);
+      }
+    }
+    buffer.push('\n');
+  }
+
+public:
+  /**
+   * @brief Drains the buffer without blocking. Must be called from the loop
+   * function.
+   *
+   * @param output the stream to which the messages are written, e.g. Serial
+   * @param maxBytes maximum number of bytes to write. If 0 only as many bytes
+   * as fit into the transmit buffer of the output are written. If the output
+   * reports no free space, e.g. because it does not implement
+   * availableForWrite, LCD_LOG_FLUSH_CHUNK bytes are written.
+   * @return number of written bytes
+   */
+  size_t flush(Print& output, size_t maxBytes = 0) {
+    if (maxBytes == 0) {
+      int available = output.availableForWrite();
+      maxBytes = available > 0 ? available : LCD_LOG_FLUSH_CHUNK;
+    }
+
+    if (droppedMessages != 0 && buffer.empty()) {
+      unsigned long dropped = droppedMessages;
+      droppedMessages = 0;
+      write(Level::warning, {"Log dropped ", dropped, " messages"});
+    }
+
+    size_t written = 0;
+    char c;
+    while ((written < maxBytes) && buffer.pop(c)) {
+      output.write((uint8_t)c);
+      written++;
+    }
+    return written;
+  }
+
+public:
+  /**
+   * @brief Returns the number of bytes waiting to be drained
+   */
+  size_t pending() const {
+    return buffer.size();
+  }
+};
+} // namespace lcd
@@ -0,0 +1,348 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "MenuSource.h"
+#include "MenuView.h"
+
+#include <Arduino.h>
+#include <RotaryEncoder.h>
+#include <functional>
+
+/**
+ * Maximum number of nested submenus of a MenuFileView
+ */
+#ifndef LCD_MENU_FILE_DEPTH
+#define LCD_MENU_FILE_DEPTH 4
+#endif
+
+/**
+ * Maximum length of a text read from a menu file. Longer texts are cut.
+ */
+#ifndef LCD_MENU_FILE_MAX_TEXT
+#define LCD_MENU_FILE_MAX_TEXT 64
+#endif
+
+namespace lcd {
+/**
+ * @brief Menu which reads a tree of menus from a binary menu file. Only the
+ * header of the shown menu and the texts of the visible rows are loaded, so
+ * the memory usage does not depend on the size of the file. Every item is
+ * found in constant time using offset tables.
+ *
+ * File format (all numbers little endian):
+ * - header: "LCDM", version (1 byte), reserved (1 byte), number of menus
+ *   (2 bytes), followed by the offset of each menu (4 bytes each)
+ * - menu: offset of the title (4 bytes), number of items (2 bytes),
+ *   reserved (2 bytes), followed by the items
+ * - item: offset of the text (4 bytes), type (1 byte: 0 action, 1 link,
+ *   2 back), reserved (1 byte), id of the action or index of the linked
+ *   menu (2 bytes)
+ * - text: length (1 byte) followed by the characters
+ *
+ * Example:
+ * @code
+ * lcd::FsMenuSource source(LittleFS.open("/menu.bin", "r"));
+ * lcd::MenuFileView menu(&display, "menu", &encoder, &source, 20, 4);
+ * void setup() {
+ *   ...
+ *   menu.setOnAction([](uint16_t id) { ... });
+ *   menu.begin();
+ * }
+ * @endcode
+ */
+class MenuFileView : public MenuView {
+public:
+  /**
+   * @brief Version of the file format
+   */
+  const static uint8_t formatVersion = 1;
+
+public:
+  /**
+   * @brief Types of the items
+   */
+  enum class ItemType : uint8_t { action = 0, link = 1, back = 2 };
+
+protected:
+  /**
+   * @brief The menu file
+   */
+  MenuSource* source;
+
+protected:
+  /**
+   * @brief Number of menus in the file, 0 if the file is invalid
+   */
+  uint16_t numberOfMenus;
+
+protected:
+  /**
+   * @brief Index of the shown menu
+   */
+  uint16_t currentMenu;
+
+protected:
+  /**
+   * @brief Offset of the first item of the shown menu
+   */
+  uint32_t itemsOffset;
+
+protected:
+  /**
+   * @brief Number of items of the shown menu
+   */
+  uint16_t numberOfItems;
+
+protected:
+  /**
+   * @brief Number of parent menus stored in the stacks
+   */
+  uint8_t depth;
+
+protected:
+  /**
+   * @brief Parents of the shown menu
+   */
+  uint16_t menuStack[LCD_MENU_FILE_DEPTH];
+
+protected:
+  /**
+   * @brief Selection of the parents of the shown menu
+   */
+  int selectionStack[LCD_MENU_FILE_DEPTH];
+
+protected:
+  /**
+   * @brief Entries of the visible rows
+   */
+  RowCache rowCache;
+
+protected:
+  /**
+   * @brief Called if an action item is selected
+   */
+  std::function<void(uint16_t)> onAction;
+
+public:
+  /**
+   * @brief Construct a view object. The file is read by begin.
+   *
+   * @param display pointer to the display instance
+   * @param name The name of the view
+   * @param encoder pointer to the encoder instance
+   * @param source the menu file
+   * @param numberOfColumns number of display-columns
+   * @param numberOfRows number of display-rows
+   * @param showTitle if true the first row shows the title of the menu
+   */
+  MenuFileView(LiquidCrystal_PCF8574* display,
+               const String& name,
+               RotaryEncoder* encoder,
+               MenuSource* source,
+               const int& numberOfColumns,
+               const int& numberOfRows,
+               const bool& showTitle = true)
+    // the title is read by begin, a placeholder reserves its row
+    : MenuView(display, name, encoder, showTitle ? " " : "", numberOfColumns, numberOfRows)
+    , source(source)
+    , numberOfMenus(0)
+    , currentMenu(0)
+    , itemsOffset(0)
+    , numberOfItems(0)
+    , depth(0) {}
+
+public:
+  /**
+   * @brief Sets the function called with the id of a selected action item
+   */
+  void setOnAction(std::function<void(uint16_t)> callback) {
+    onAction = std::move(callback);
+  }
+
+public:
+  /**
+   * @brief Reads the header of the file and loads the root menu
+   *
+   * @return false if the file is invalid
+   */
+  bool begin() {
+    uint8_t header[8];
+    numberOfMenus = 0;
+    if (!source->read(0, header, sizeof(header)) || (memcmp(header, "LCDM", 4) != 0) ||
+        (header[4] != formatVersion)) {
+      LCD_LOG_ERROR("Invalid menu file");
+      return false;
+    }
+    numberOfMenus = header[6] | (header[7] << 8);
+    depth = 0;
+    if ((numberOfMenus == 0) || !loadMenu(0)) {
+      LCD_LOG_ERROR("Invalid menu file");
+      numberOfMenus = 0;
+      return false;
+    }
+    return true;
+  }
+
+protected:
+  /**
+   * @brief Loads the header of a menu
+   *
+   * @return false if the menu could not be read
+   */
+  bool loadMenu(const uint16_t& menu) {
+    uint8_t buffer[8];
+    if ((menu >= numberOfMenus) || !source->read(8 + 4 * (uint32_t)menu, buffer, 4)) {
+      return false;
+    }
+    const uint32_t menuOffset = readUint32(buffer);
+    if (!source->read(menuOffset, buffer, 8)) {
+      return false;
+    }
+    currentMenu = menu;
+    itemsOffset = menuOffset + 8;
+    numberOfItems = buffer[4] | (buffer[5] << 8);
+    title.setText(readText(readUint32(buffer)));
+    rowCache.invalidate();
+    jumpIndex.invalidate();
+    return true;
+  }
+
+protected:
+  /**
+   * @brief Reads a text of the file
+   */
+  String readText(const uint32_t& offset) {
+    uint8_t length = 0;
+    char text[LCD_MENU_FILE_MAX_TEXT + 1];
+    if (!source->read(offset, &length, 1)) {
+      return String();
+    }
+    length = length < LCD_MENU_FILE_MAX_TEXT ? length : LCD_MENU_FILE_MAX_TEXT;
+    if (!source->read(offset + 1, (uint8_t*)text, length)) {
+      return String();
+    }
+    text[length] = 0;
+    return String(text);
+  }
+
+protected:
+  /**
+   * @brief Reads an item of the shown menu
+   *
+   * @param index index of the item
+   * @param buffer receives the 8 bytes of the item
+   */
+  bool readItem(const int& index, uint8_t* buffer) {
+    return source->read(itemsOffset + 8 * (uint32_t)index, buffer, 8);
+  }
+
+protected:
+  /**
+   * @brief Decodes a little endian 32 bit number
+   */
+  static uint32_t readUint32(const uint8_t* buffer) {
+    return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+  }
+
+protected:
+  /**
+   * @brief called as soon as the view becomes active
+   */
+  virtual void activate() {
+    rowCache.invalidate();
+    MenuView::activate();
+  }
+
+protected:
+  /**
+   * @brief Shows another menu of the file
+   *
+   * @param menu index of the menu
+   * @param newSelection the selected item
+   */
+  void showMenu(const uint16_t& menu, const int& newSelection) {
+    if (!loadMenu(menu)) {
+      LCD_LOG_ERROR("Cannot read menu ", (unsigned)menu);
+      return;
+    }
+    selection = newSelection < numberOfItems ? newSelection : 0;
+    firstVisibleItem = 0;
+    updateFirstVisibleItem();
+    redraw();
+  }
+
+protected:
+  virtual int getNumberOfItems() {
+    return numberOfMenus ? numberOfItems : 0;
+  }
+
+protected:
+  virtual LongEntry& getEntry(const int& index) {
+    LongEntry* entry = rowCache.find(index, numberOfRowsUsedForItems);
+    if (!entry) {
+      uint8_t buffer[8];
+      entry = &rowCache.assign(index, numberOfRowsUsedForItems,
+                               readItem(index, buffer) ? readText(readUint32(buffer)) : String("?"));
+    }
+    return *entry;
+  }
+
+protected:
+  virtual String getItemText(const int& index) {
+    uint8_t buffer[8];
+    return readItem(index, buffer) ? readText(readUint32(buffer)) : String();
+  }
+
+protected:
+  virtual bool isItemEnabled(const int& index) {
+    return true;
+  }
+
+protected:
+  virtual void selectItem(const int& index) {
+    uint8_t buffer[8];
+    if (!readItem(index, buffer)) {
+      return;
+    }
+    const uint16_t target = buffer[6] | (buffer[7] << 8);
+    switch ((ItemType)buffer[4]) {
+    case ItemType::action:
+      if (onAction) {
+        onAction(target);
+      }
+      break;
+    case ItemType::link:
+      // if the stack is full the deepest parent is not stored
+      if (depth < LCD_MENU_FILE_DEPTH) {
+        menuStack[depth] = currentMenu;
+        selectionStack[depth] = selection;
+        depth++;
+      }
+      showMenu(target, 0);
+      break;
+    case ItemType::back:
+      goBack();
+      break;
+    }
+  }
+
+protected:
+  /**
+   * @brief Returns to the parent menu or to the previous view if the root
+   * menu is shown
+   */
+  virtual bool goBack() {
+    if (depth == 0) {
+      return MenuView::goBack();
+    }
+    depth--;
+    showMenu(menuStack[depth], selectionStack[depth]);
+    return true;
+  }
+};
+
+LCD_ASSERT_SIZE(MenuFileView, LCD_BUDGET_MENU_FILE_VIEW);
+} // namespace lcd
@@ -0,0 +1,152 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+#include <FS.h>
+#endif
+#if !defined(ARDUINO)
+#include <stdio.h>
+#include <string.h>
+#endif
+
+namespace lcd {
+/**
+ * @brief Random access to a binary file, e.g. a menu file created by
+ * tools/menu_compiler.py or a string table created by
+ * tools/string_compiler.py
+ */
+class MenuSource {
+public:
+  /**
+   * @brief Destroy the source
+   */
+  virtual ~MenuSource() {}
+
+public:
+  /**
+   * @brief Reads bytes from the file
+   *
+   * @param offset position of the first byte
+   * @param buffer receives the bytes
+   * @param length number of bytes to read
+   * @return false if the bytes could not be read
+   */
+  virtual bool read(const uint32_t& offset, uint8_t* buffer, const size_t& length) = 0;
+};
+
+/**
+ * @brief File which is stored in memory, e.g. in PROGMEM
+ */
+class MemoryMenuSource : public MenuSource {
+protected:
+  /**
+   * @brief The content of the file
+   */
+  const uint8_t* data;
+
+protected:
+  /**
+   * @brief Size of the file in bytes
+   */
+  const size_t size;
+
+public:
+  /**
+   * @brief Construct a new source
+   *
+   * @param data the content of the file
+   * @param size size of the file in bytes
+   */
+  MemoryMenuSource(const uint8_t* data, const size_t& size)
+    : data(data)
+    , size(size) {}
+
+public:
+  virtual bool read(const uint32_t& offset, uint8_t* buffer, const size_t& length) {
+    if ((offset > size) || (length > size - offset)) {
+      return false;
+    }
+#if defined(ARDUINO_ARCH_AVR) || defined(ARDUINO_ARCH_ESP8266)
+    memcpy_P(buffer, data + offset, length);
+#else
+    memcpy(buffer, data + offset, length);
+#endif
+    return true;
+  }
+};
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+/**
+ * @brief File which is read from a file system, e.g. LittleFS
+ */
+class FsMenuSource : public MenuSource {
+protected:
+  /**
+   * @brief The opened file
+   */
+  fs::File file;
+
+public:
+  /**
+   * @brief Construct a new source
+   *
+   * @param file the opened file
+   */
+  FsMenuSource(const fs::File& file)
+    : file(file) {}
+
+public:
+  virtual bool read(const uint32_t& offset, uint8_t* buffer, const size_t& length) {
+    return file && file.seek(offset) && (file.read(buffer, length) == length);
+  }
+};
+#endif
+
+#if !defined(ARDUINO)
+/**
+ * @brief File which is read using stdio
+ */
+class FileMenuSource : public MenuSource {
+protected:
+  /**
+   * @brief The opened file
+   */
+  FILE* file;
+
+public:
+  /**
+   * @brief Opens the file
+   *
+   * @param path path of the file
+   */
+  FileMenuSource(const char* path)
+    : file(fopen(path, "rb")) {}
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  FileMenuSource(const FileMenuSource& other) = delete;
+
+public:
+  /**
+   * @brief Closes the file
+   */
+  virtual ~FileMenuSource() {
+    if (file) {
+      fclose(file);
+    }
+  }
+
+public:
+  virtual bool read(const uint32_t& offset, uint8_t* buffer, const size_t& length) {
+    return file && (fseek(file, offset, SEEK_SET) == 0) && (fread(buffer, 1, length, file) == length);
+  }
+};
+#endif
+} // namespace lcd
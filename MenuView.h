@@ -4,23 +4,51 @@
  */
 #pragma once
 
+#include "FenwickTree.h"
+#include "QuickJumpIndex.h"
+#include "StringTable.h"
 #include "ViewBase.h"
 
 #include <Arduino.h>
 #include <RotaryEncoder.h>
-#include <list>
+#include <deque>
 
 namespace lcd {
 /**
  * @brief View which can be used for menus
  */
 class MenuView : public ViewBase {
+  friend class StressHarness;
+
 public:
   /**
    * @brief Class providing scrolling capabilities for a string which is longer
    * than the display.
    */
   class LongEntry {
+  public:
+    /**
+     * @brief Defines how a text which is longer than the display is animated
+     */
+    enum class MarqueeMode {
+      /**
+       * @brief The text scrolls to its end and back to its beginning
+       */
+      bounce,
+      /**
+       * @brief The text scrolls continuously in one direction, separated by
+       * spaces from its next repetition
+       */
+      ticker
+    };
+
+  public:
+    /**
+     * @brief Number of spaces between two repetitions in ticker mode
+     */
+    static const size_t tickerGap = 3;
+
+#if LCD_FEATURE_MARQUEE
   protected:
     /**
      * @brief position of the first shown character
@@ -32,6 +60,59 @@ public:
      * @brief If true the animation is currently scrolling forwards
      */
     bool scrollForwards;
+#endif
+
+  protected:
+    /**
+     * @brief If true the text changed since it was shown the last time
+     */
+    bool modified;
+
+#if LCD_FEATURE_MARQUEE
+
+  protected:
+    /**
+     * @brief How the text is animated
+     */
+    MarqueeMode marqueeMode;
+
+  protected:
+    /**
+     * @brief Number of steps the animation pauses at the ends of the text
+     */
+    uint8_t pauseSteps;
+
+  protected:
+    /**
+     * @brief Number of steps remaining in the current pause
+     */
+    uint8_t remainingPauseSteps;
+
+  protected:
+    /**
+     * @brief Interval in milliseconds between two animation steps
+     */
+    unsigned long stepInterval;
+
+  protected:
+    /**
+     * @brief millis value of the next animation step
+     */
+    uint32_t nextStep;
+
+  protected:
+    /**
+     * @brief maxLength for which scrollRange was calculated
+     */
+    size_t scrollRangeMaxLength;
+
+  protected:
+    /**
+     * @brief Number of positions the text can be moved. In ticker mode this is
+     * the length of one period. 0 if the text fits completely.
+     */
+    size_t scrollRange;
+#endif
 
   protected:
     /**
@@ -45,9 +126,23 @@ public:
      *
      * @param text the text which should be displayed
      */
-    LongEntry(const String& text)
-      : showPosition(0)
-      , scrollForwards(false)
+    LongEntry(const String& text = String())
+      :
+#if LCD_FEATURE_MARQUEE
+      showPosition(0)
+      , scrollForwards(true)
+      ,
+#endif
+      modified(false)
+#if LCD_FEATURE_MARQUEE
+      , marqueeMode(MarqueeMode::bounce)
+      , pauseSteps(1)
+      , remainingPauseSteps(1)
+      , stepInterval(500)
+      , nextStep(Clock::get().millis())
+      , scrollRangeMaxLength(0)
+      , scrollRange(0)
+#endif
       , text(text) {}
 
   public:
@@ -61,35 +156,91 @@ public:
      * @brief Move constructor
      */
     LongEntry(LongEntry&& other) noexcept
-      : showPosition(std::move(other.showPosition))
+      :
+#if LCD_FEATURE_MARQUEE
+      showPosition(std::move(other.showPosition))
       , scrollForwards(std::move(other.scrollForwards))
+      ,
+#endif
+      modified(std::move(other.modified))
+#if LCD_FEATURE_MARQUEE
+      , marqueeMode(std::move(other.marqueeMode))
+      , pauseSteps(std::move(other.pauseSteps))
+      , remainingPauseSteps(std::move(other.remainingPauseSteps))
+      , stepInterval(std::move(other.stepInterval))
+      , nextStep(std::move(other.nextStep))
+      , scrollRangeMaxLength(std::move(other.scrollRangeMaxLength))
+      , scrollRange(std::move(other.scrollRange))
+#endif
       , text(std::move(other.text)) {}
 
   public:
     /**
-     * @brief moves the string by one position if necessary
+     * @brief Configures the animation of the text
+     *
+     * @param mode how the text is animated
+     * @param stepInterval interval in milliseconds between two steps
+     * @param pauseSteps number of steps the animation pauses at the ends
+     */
+    void setMarquee(const MarqueeMode& mode, const unsigned long& stepInterval, const uint8_t& pauseSteps) {
+#if LCD_FEATURE_MARQUEE
+      this->marqueeMode = mode;
+      this->stepInterval = stepInterval;
+      this->pauseSteps = pauseSteps;
+      updateScrollRange(scrollRangeMaxLength);
+      resetAnimation();
+#endif
+    }
+
+  public:
+    /**
+     * @brief moves the string by one position if its next step is due
      *
      * @param maxLength maximum number of characters which should be displayed
+     * @param now the current millis value
+     * @param slowdown factor by which the step interval is extended, e.g.
+     * while the display is saturated
+     * @return true if the shown part of the text changed
      */
-    void animationTick(const size_t& maxLength) {
-      if (text.length() > maxLength) {
-        if (scrollForwards) {
-          if (text.length() - showPosition <= maxLength) {
-            scrollForwards = false;
-          }
-          else {
-            showPosition++;
-          }
+    bool animationTick(const size_t& maxLength, const uint32_t& now, const uint8_t& slowdown = 1) {
+#if !LCD_FEATURE_MARQUEE
+      return false;
+#else
+      if (scrollRangeMaxLength != maxLength) {
+        updateScrollRange(maxLength);
+      }
+      if ((scrollRange == 0) || !Clock::reached(now, nextStep)) {
+        return false;
+      }
+      nextStep = now + stepInterval * slowdown;
+
+      if (remainingPauseSteps != 0) {
+        remainingPauseSteps--;
+        return false;
+      }
+
+      if (marqueeMode == MarqueeMode::ticker) {
+        showPosition = (showPosition + 1) % scrollRange;
+        if (showPosition == 0) {
+          remainingPauseSteps = pauseSteps;
         }
-        else {
-          if (showPosition == 0) {
-            scrollForwards = true;
-          }
-          else {
-            showPosition--;
-          }
+      }
+      else if (scrollForwards) {
+        showPosition++;
+        if (showPosition >= scrollRange) {
+          scrollForwards = false;
+          remainingPauseSteps = pauseSteps;
+        }
+      }
+      else {
+        showPosition--;
+        if (showPosition == 0) {
+          scrollForwards = true;
+          remainingPauseSteps = pauseSteps;
         }
       }
+      return true;
+#endif
     }
 
   public:
@@ -97,8 +248,35 @@ public:
      * @brief Resets the animation to its initial state
      */
     void resetAnimation() {
+#if LCD_FEATURE_MARQUEE
       showPosition = 0;
-      scrollForwards = false;
+      scrollForwards = true;
+      remainingPauseSteps = pauseSteps;
+      nextStep = Clock::get().millis() + stepInterval;
+#endif
+    }
+
+  protected:
+    /**
+     * @brief Calculates how far the text can be moved. This is done once when
+     * the text or the available space changes and not in every step.
+     */
+    void updateScrollRange(const size_t& maxLength) {
+#if LCD_FEATURE_MARQUEE
+      scrollRangeMaxLength = maxLength;
+      if (text.length() <= maxLength) {
+        scrollRange = 0;
+      }
+      else if (marqueeMode == MarqueeMode::ticker) {
+        scrollRange = text.length() + tickerGap;
+      }
+      else {
+        scrollRange = text.length() - maxLength;
+      }
+      if (showPosition >= scrollRange) {
+        showPosition = 0;
+      }
+#endif
     }
 
   public:
@@ -109,7 +287,15 @@ public:
      * @param maxLength maximum number of characters which should be displayed
      * @param fullRedraw if true trailing spaces are drawn if the text is too short.
      */
-    virtual void show(LiquidCrystal_PCF8574* display, const size_t& maxLength, const bool& fullRedraw) {
+    virtual void show(Print* display, const size_t& maxLength, const bool& fullRedraw) {
+      modified = false;
+#if LCD_FEATURE_MARQUEE
+      // the space changes without an animation step if a row is redrawn or
+      // reset, e.g. when the scrollbar appears
+      if (scrollRangeMaxLength != maxLength) {
+        updateScrollRange(maxLength);
+      }
+#endif
       if (text.length() <= maxLength) {
         display->write(text.c_str());
         if (fullRedraw) {
@@ -118,9 +304,25 @@ public:
           }
         }
       }
+#if !LCD_FEATURE_MARQUEE
+      else {
+        display->write(text.c_str(), maxLength);
+      }
+#else
+      else if (scrollRange == 0) {
+        // not scrolled
+        display->write(text.c_str(), maxLength);
+      }
+      else if (marqueeMode == MarqueeMode::ticker) {
+        for (size_t i = 0; i < maxLength; i++) {
+          const size_t position = (showPosition + i) % scrollRange;
+          display->write(position < text.length() ? text[position] : ' ');
+        }
+      }
       else {
         display->write(text.c_str() + showPosition, maxLength);
       }
+#endif
     }
 
   public:
@@ -133,12 +335,43 @@ public:
 
   public:
     /**
-     * @brief Sets the text of the item
+     * @brief Sets the text of the item. If the item is visible only its row is
+     * redrawn during the next tick of the menu.
      */
     void setText(const String& newText) {
-      text = newText;
-      resetAnimation();
+      if (text != newText) {
+        text = newText;
+        modified = true;
+#if LCD_FEATURE_MARQUEE
+        updateScrollRange(scrollRangeMaxLength);
+        resetAnimation();
+#endif
+      }
     }
+
+  public:
+    /**
+     * @brief Returns true if the text changed since it was shown the last time
+     */
+    bool isModified() const {
+      return modified;
+    }
+  };
+
+public:
+  /**
+   * @brief Defines how the visible items follow the selection
+   */
+  enum class ScrollMode {
+    /**
+     * @brief The items are shown in pages of numberOfRowsUsedForItems entries
+     */
+    page,
+    /**
+     * @brief The visible items are moved by one row as soon as the selection
+     * leaves the displayed rows
+     */
+    follow
   };
 
 public:
@@ -146,12 +379,51 @@ public:
    * @brief Class handling one menu entry with a callback function
    */
   class MenuItem : public LongEntry {
+    friend class MenuView;
+
   public:
     /**
      * @brief Callback function which is called as soon as the item is selected
      */
     const std::function<void(MenuItem*)> callback;
 
+  protected:
+    /**
+     * @brief The menu containing the item
+     */
+    MenuView* owner;
+
+  protected:
+    /**
+     * @brief Index of the item in the menu including the hidden items
+     */
+    size_t index;
+
+  protected:
+    /**
+     * @brief If false the item is not shown
+     */
+    bool visible;
+
+  protected:
+    /**
+     * @brief If false the item is shown but cannot be selected
+     */
+    bool enabled;
+
+  protected:
+    /**
+     * @brief Number of the text in the string tables or noText
+     */
+    TextId textId;
+
+  protected:
+    /**
+     * @brief Revision of the string table the text was loaded from, 0 if it
+     * was never loaded
+     */
+    uint16_t textRevision;
+
   public:
     /**
      * @brief Creates a new item
@@ -161,7 +433,31 @@ public:
      */
     MenuItem(const String& text, const std::function<void(MenuItem*)>& callback)
       : LongEntry(text)
-      , callback(callback) {}
+      , callback(callback)
+      , owner(nullptr)
+      , index(0)
+      , visible(true)
+      , enabled(true)
+      , textId(noText)
+      , textRevision(0) {}
+
+  public:
+    /**
+     * @brief Creates a new item whose text is read from the current string
+     * table as soon as it is shown
+     *
+     * @param textId number of the text in the string tables
+     * @param callback callback as soon as the item is selected
+     */
+    MenuItem(const TextId& textId, const std::function<void(MenuItem*)>& callback)
+      : LongEntry()
+      , callback(callback)
+      , owner(nullptr)
+      , index(0)
+      , visible(true)
+      , enabled(true)
+      , textId(textId)
+      , textRevision(0) {}
 
   public:
     /**
@@ -175,14 +471,129 @@ public:
      */
     MenuItem(MenuItem&& other) noexcept
       : LongEntry(std::move(other))
-      , callback(std::move(other.callback)) {}
+      , callback(std::move(other.callback))
+      , owner(std::move(other.owner))
+      , index(std::move(other.index))
+      , visible(std::move(other.visible))
+      , enabled(std::move(other.enabled))
+      , textId(std::move(other.textId))
+      , textRevision(std::move(other.textRevision)) {}
+
+  public:
+    /**
+     * @brief Shows or hides the item. The selection stays on the selected item
+     * and only the rows below the item are redrawn during the next tick.
+     */
+    void setVisible(const bool& newVisible) {
+      if (visible != newVisible) {
+        visible = newVisible;
+        if (owner) {
+          owner->itemVisibilityChanged(index, visible);
+        }
+      }
+    }
+
+  public:
+    /**
+     * @brief Returns true if the item is shown
+     */
+    bool isVisible() const {
+      return visible;
+    }
+
+  public:
+    /**
+     * @brief Enables or disables the item. A disabled item is marked with '-',
+     * skipped by the selection and cannot be selected.
+     */
+    void setEnabled(const bool& newEnabled) {
+      if (enabled != newEnabled) {
+        enabled = newEnabled;
+        modified = true;
+      }
+    }
+
+  public:
+    /**
+     * @brief Returns true if the item can be selected
+     */
+    bool isEnabled() const {
+      return enabled;
+    }
+
+  public:
+    /**
+     * @brief Returns the number of the text in the string tables or noText.
+     * getText of such an item returns the text loaded when it was shown the
+     * last time.
+     */
+    TextId getTextId() const {
+      return textId;
+    }
   };
 
 protected:
   /**
-   * @brief millis value of the last redraw
+   * @brief Entries of the visible rows for menus which do not store an entry
+   * for each item, e.g. menus read from tables. The entry of an item is kept
+   * as long as its row shows it, so its animation continues.
    */
-  unsigned long lastMillisForAnimationRefresh;
+  class RowCache {
+  protected:
+    /**
+     * @brief The entries of the rows
+     */
+    LongEntry entries[LCD_FRAME_ROWS];
+
+  protected:
+    /**
+     * @brief Index of the item shown by each entry or -1
+     */
+    int indices[LCD_FRAME_ROWS];
+
+  public:
+    /**
+     * @brief Construct an empty cache
+     */
+    RowCache() {
+      invalidate();
+    }
+
+  public:
+    /**
+     * @brief Forgets all entries, e.g. if the items changed
+     */
+    void invalidate() {
+      std::fill_n(indices, LCD_FRAME_ROWS, -1);
+    }
+
+  public:
+    /**
+     * @brief Returns the entry of an item or nullptr if it is not cached
+     *
+     * @param index index of the item
+     * @param rows number of rows used for items
+     */
+    LongEntry* find(const int& index, const int& rows) {
+      const int slot = index % rows;
+      return indices[slot] == index ? &entries[slot] : nullptr;
+    }
+
+  public:
+    /**
+     * @brief Stores the text of an item in the entry of its row
+     *
+     * @param index index of the item
+     * @param rows number of rows used for items
+     * @param text text of the item
+     */
+    LongEntry& assign(const int& index, const int& rows, const String& text) {
+      const int slot = index % rows;
+      indices[slot] = index;
+      entries[slot].setText(text);
+      return entries[slot];
+    }
+  };
 
 protected:
   /**
@@ -198,9 +609,17 @@ protected:
 
 protected:
   /**
-   * @brief List of menu items
+   * @brief List of menu items. A deque keeps the references returned by
+   * createMenuItem valid and allows indexed access.
    */
-  std::list<MenuItem> menuItems;
+  std::deque<MenuItem> menuItems;
+
+protected:
+  /**
+   * @brief Counts the visible items of menuItems, so the n-th visible item and
+   * the position of an item are found in O(log n)
+   */
+  FenwickTree visibleItems;
 
 protected:
   /**
@@ -208,6 +627,94 @@ protected:
    */
   int selection;
 
+protected:
+  /**
+   * @brief Index of the menu item shown in the first row used for items
+   */
+  int firstVisibleItem;
+
+protected:
+  /**
+   * @brief Position of the first row whose item changed since the last tick
+   * because items were shown or hidden, -1 if no item moved
+   */
+  int firstMovedItem;
+
+protected:
+  /**
+   * @brief True if the scrollbar was drawn by the last redraw
+   */
+  bool scrollbarShown;
+
+protected:
+  /**
+   * @brief First pixel row of the shown scrollbar thumb, -1 if the thumb
+   * must be drawn again
+   */
+  int thumbStart;
+
+protected:
+  /**
+   * @brief Pixel row after the end of the shown scrollbar thumb
+   */
+  int thumbEnd;
+
+protected:
+  /**
+   * @brief How the visible items follow the selection
+   */
+  ScrollMode scrollMode;
+
+protected:
+  /**
+   * @brief If true only the selected item is animated
+   */
+  bool animateSelectedOnly;
+
+protected:
+  /**
+   * @brief If true press-and-turn jumps to the next or previous group of
+   * items starting with the same letter instead of moving by one page
+   */
+  bool quickJump;
+
+protected:
+  /**
+   * @brief If true the selection was reached by a quick jump and its marker
+   * shows the letter of its group
+   */
+  bool showGroupLetter;
+
+protected:
+  /**
+   * @brief Groups of the items used by quick jumps, built on the first jump
+   */
+  QuickJumpIndex jumpIndex;
+
+protected:
+  /**
+   * @brief If set the selection is stored persistently
+   */
+  PersistentState* persistentState;
+
+protected:
+  /**
+   * @brief Key of the selection in the persistent state
+   */
+  uint8_t persistentStateKey;
+
+protected:
+  /**
+   * @brief Number of the title in the string tables or noText
+   */
+  TextId titleId;
+
+protected:
+  /**
+   * @brief Revision of the string table the texts were loaded from
+   */
+  uint16_t textRevision;
+
 public:
   /**
    * @brief Number of display-columns
@@ -247,9 +754,48 @@ public:
     , encoder(encoder)
     , title(title)
     , selection(0)
+    , firstVisibleItem(0)
+    , firstMovedItem(-1)
+    , scrollbarShown(false)
+    , thumbStart(-1)
+    , thumbEnd(-1)
+    , scrollMode(ScrollMode::page)
+    , animateSelectedOnly(false)
+    , quickJump(false)
+    , showGroupLetter(false)
+    , persistentState(nullptr)
+    , persistentStateKey(0)
+    , titleId(noText)
+    , textRevision(0)
     , numberOfColumns(numberOfColumns)
     , numberOfRows(numberOfRows)
-    , numberOfRowsUsedForItems(((numberOfRows > 1) && (title.length() != 0)) ? numberOfRows - 1 : numberOfRows) {}
+    , numberOfRowsUsedForItems(((numberOfRows > 1) && (title.length() != 0)) ? numberOfRows - 1 : numberOfRows) {
+    ViewBase::display->setSize(numberOfColumns, numberOfRows);
+    getInput().useEncoder(encoder);
+  }
+
+public:
+  /**
+   * @brief Construct a view object whose title is read from the current
+   * string table
+   *
+   * @param display pointer to the display instance
+   * @param name The name of the view
+   * @param encoder pointer to the encoder instance
+   * @param title number of the title in the string tables
+   * @param numberOfColumns number of display-columns
+   * @param numberOfRows number of display-rows
+   */
+  MenuView(LiquidCrystal_PCF8574* display,
+           const String& name,
+           RotaryEncoder* encoder,
+           const TextId& title,
+           const int& numberOfColumns,
+           const int& numberOfRows)
+    // the title is loaded by the first tick, a placeholder reserves its row
+    : MenuView(display, name, encoder, " ", numberOfColumns, numberOfRows) {
+    titleId = title;
+  }
 
 public:
   /**
@@ -263,14 +809,32 @@ public:
    */
   MenuView(MenuView&& other) noexcept
     : ViewBase(std::move(other))
-    , lastMillisForAnimationRefresh(std::move(other.lastMillisForAnimationRefresh))
     , encoder(std::move(other.encoder))
     , title(std::move(other.title))
     , menuItems(std::move(other.menuItems))
+    , visibleItems(std::move(other.visibleItems))
     , selection(std::move(other.selection))
+    , firstVisibleItem(std::move(other.firstVisibleItem))
+    , firstMovedItem(std::move(other.firstMovedItem))
+    , scrollbarShown(std::move(other.scrollbarShown))
+    , thumbStart(std::move(other.thumbStart))
+    , thumbEnd(std::move(other.thumbEnd))
+    , scrollMode(std::move(other.scrollMode))
+    , animateSelectedOnly(std::move(other.animateSelectedOnly))
+    , quickJump(std::move(other.quickJump))
+    , showGroupLetter(std::move(other.showGroupLetter))
+    , jumpIndex(std::move(other.jumpIndex))
+    , persistentState(std::move(other.persistentState))
+    , persistentStateKey(std::move(other.persistentStateKey))
+    , titleId(std::move(other.titleId))
+    , textRevision(std::move(other.textRevision))
     , numberOfColumns(other.numberOfColumns)
     , numberOfRows(other.numberOfRows)
-    , numberOfRowsUsedForItems(other.numberOfRowsUsedForItems) {}
+    , numberOfRowsUsedForItems(other.numberOfRowsUsedForItems) {
+    for (auto& item : menuItems) {
+      item.owner = this;
+    }
+  }
 
 protected:
   /**
@@ -279,39 +843,32 @@ protected:
   virtual void activate() {
     // copy special characters to display
     ViewBase::initializeSpecialCharacters();
-    display->clear();
 
-    if (((int)menuItems.size() > numberOfRowsUsedForItems) && (numberOfRows > 1)) {
-      // draw a scrollbar
-      if (numberOfRows == 2) {
-        display->setCursor(numberOfColumns - 1, 0);
-        display->write(scScrollbarTop);
-        display->setCursor(numberOfColumns - 1, 1);
-        display->write(scScrollbarBottom);
-        display->setCursor(0, 0);
-        title.show(display, numberOfColumns - 1, true);
-      }
-      else if (numberOfRows == 4) {
-        if (numberOfRows == numberOfRowsUsedForItems) {
-          display->setCursor(numberOfColumns - 1, 0);
-          display->write(scScrollbarTop);
-          display->setCursor(numberOfColumns - 1, 1);
-          display->write(scScrollbarMiddle);
-        }
-        else {
-          display->setCursor(numberOfColumns - 1, 1);
-          display->write(scScrollbarTop);
-          display->setCursor(0, 0);
-          title.show(display, numberOfColumns, true);
-        }
-        display->setCursor(numberOfColumns - 1, 2);
-        display->write(scScrollbarMiddle);
-        display->setCursor(numberOfColumns - 1, 3);
-        display->write(scScrollbarBottom);
-      }
+    // restore the selection of the last visit
+    int16_t storedSelection = 0;
+    if (persistentState && persistentState->get(persistentStateKey, storedSelection) && (storedSelection >= 0) &&
+        (storedSelection < getNumberOfItems())) {
+      selection = storedSelection;
+    }
+    else {
+      selection = 0;
     }
-    lastMillisForAnimationRefresh = millis() - 500;
-    selection = 0;
+    firstVisibleItem = 0;
+    showGroupLetter = false;
+    redraw();
+  }
+
+protected:
+  /**
+   * @brief Clears the display and draws the scrollbar, the title and the
+   * visible items again
+   */
+  void redraw() {
+    display->clear();
+    firstMovedItem = -1;
+
+    scrollbarShown = (getNumberOfItems() > numberOfRowsUsedForItems) && (numberOfRows > 1);
+    thumbStart = -1;
     tick(true);
   }
 
@@ -322,106 +879,477 @@ public:
    * @param forceRedraw if true everything should be redrawn
    */
   virtual void tick(const bool& forceRedraw) {
-    const bool animationTickRequired = lastMillisForAnimationRefresh + 500 <= millis();
-    auto encoderUpdate = encoder->getDirection();
-    auto encoderClicked = encoder->getNewClick();
-    bool fullRedraw = false;
-    bool redraw = animationTickRequired;
+    // the texts are loaded again after the language changed
+    if (textRevision != StringTable::getRevision()) {
+      textRevision = StringTable::getRevision();
+      textsChanged();
+      if (!forceRedraw) {
+        redraw();
+        return;
+      }
+    }
+
+    // showing or hiding items can add or remove the scrollbar
+    if (!forceRedraw && (scrollbarShown != ((getNumberOfItems() > numberOfRowsUsedForItems) && (numberOfRows > 1)))) {
+      redraw();
+      return;
+    }
+
+    const uint32_t now = Clock::get().millis();
+    // animations are slowed down while the display cannot keep up
+    const uint8_t slowdown = display->getGovernor().getAnimationSlowdown();
+    const InputEvent event = readInput();
 
     // Update the backlight timeout
-    if (encoderClicked || (encoderUpdate != RotaryEncoder::Direction::NOROTATION)) {
+    if (event != InputEvent::none) {
       if (!getBacklightTimeoutManager().delayTimeout()) {
+        getBacklightTimeoutManager().tick(display);
+        display->present();
         return;
       }
     }
     getBacklightTimeoutManager().tick(display);
 
+    if ((event == InputEvent::back) && goBack()) {
+      return;
+    }
+
+    const int numberOfItems = getNumberOfItems();
+
     // check if the scrollbar is visible
     size_t maxLength = numberOfColumns - 1;
-    if (((int)menuItems.size() > numberOfRowsUsedForItems) && (numberOfRows > 1)) {
+    if ((numberOfItems > numberOfRowsUsedForItems) && (numberOfRows > 1)) {
       maxLength = numberOfColumns - 2;
     }
 
     // check if we have to update the selection
-    if ((encoderUpdate == RotaryEncoder::Direction::CLOCKWISE) && (selection + 1 < (int)menuItems.size())) {
-      selection++;
-      redraw = true;
-      fullRedraw = selection % numberOfRowsUsedForItems == 0; // New page displayed
+    const int previousSelection = selection;
+    const bool previousShowGroupLetter = showGroupLetter;
+    int nextSelection = -1;
+    if ((event == InputEvent::pressTurnDown) && quickJump) {
+      // jump to the first item of the next letter
+      updateJumpIndex(numberOfItems);
+      const int target = jumpIndex.next(selection);
+      if (target >= 0) {
+        nextSelection = findEnabledItem(target, 1, numberOfItems);
+        showGroupLetter = true;
+      }
     }
-    else if ((encoderUpdate == RotaryEncoder::Direction::COUNTERCLOCKWISE) && (selection != 0)) {
-      selection--;
-      redraw = true;
-      fullRedraw = selection % numberOfRowsUsedForItems == 2; // New page displayed
+    else if ((event == InputEvent::pressTurnUp) && quickJump) {
+      // jump to the first item of the current or previous letter
+      updateJumpIndex(numberOfItems);
+      const int target = jumpIndex.previous(selection);
+      if (target >= 0) {
+        nextSelection = findEnabledItem(target, 1, numberOfItems);
+        showGroupLetter = true;
+      }
+    }
+    else if (event == InputEvent::down) {
+      nextSelection = findEnabledItem(selection + 1, 1, numberOfItems);
+      showGroupLetter = false;
+    }
+    else if (event == InputEvent::up) {
+      nextSelection = findEnabledItem(selection - 1, -1, numberOfItems);
+      showGroupLetter = false;
+    }
+    else if (event == InputEvent::pressTurnDown) {
+      // move by one page
+      const int target = std::min(selection + numberOfRowsUsedForItems, std::max(numberOfItems - 1, 0));
+      nextSelection = findEnabledItem(target, 1, numberOfItems);
+      if (nextSelection < 0) {
+        nextSelection = findEnabledItem(target, -1, numberOfItems);
+      }
+    }
+    else if (event == InputEvent::pressTurnUp) {
+      const int target = std::max(selection - numberOfRowsUsedForItems, 0);
+      nextSelection = findEnabledItem(target, -1, numberOfItems);
+      if (nextSelection < 0) {
+        nextSelection = findEnabledItem(target, 1, numberOfItems);
+      }
     }
+    if (nextSelection >= 0) {
+      selection = nextSelection;
+    }
+
+    if (persistentState && (selection != previousSelection)) {
+      persistentState->set(persistentStateKey, (int16_t)selection);
+    }
+
+    // check if other items must be displayed
+    const int previousFirstVisibleItem = firstVisibleItem;
+    updateFirstVisibleItem();
+    const bool fullRedraw = forceRedraw || (firstVisibleItem != previousFirstVisibleItem);
 
     // Update name of the Menu
-    if ((animationTickRequired || fullRedraw) && (numberOfRows != numberOfRowsUsedForItems)) {
-      display->setCursor(0, 0);
-      if (numberOfRows == 2) {
-        title.animationTick(numberOfColumns - 1);
-        title.show(display, numberOfColumns - 1, false);
+    if (numberOfRows != numberOfRowsUsedForItems) {
+      const size_t titleLength = numberOfRows == 2 ? numberOfColumns - 1 : numberOfColumns;
+      const bool titleModified = forceRedraw || title.isModified();
+      if (titleModified) {
+        title.resetAnimation();
       }
-      else if (numberOfRows == 4) {
-        title.animationTick(numberOfColumns);
-        title.show(display, numberOfColumns, false);
+      if (title.animationTick(titleLength, now, slowdown) || titleModified) {
+        display->setCursor(0, 0);
+        title.show(display, titleLength, titleModified);
       }
     }
 
-    // redraw menu entries if necessary
-    if (redraw) {
-      // select the first entry to be shown
-      auto itEntry = menuItems.begin();
-      std::advance(itEntry, selection - (selection % numberOfRowsUsedForItems));
+    // Redraw the rows which changed. This are all rows if other items are
+    // displayed, the rows of the old and the new selection, the rows below a
+    // shown or hidden item and the rows whose text was modified or whose
+    // animation moved.
+    for (int i = 0; i < numberOfRowsUsedForItems; i++) {
+      const int index = firstVisibleItem + i;
+      const bool moved = (firstMovedItem >= 0) && (index >= firstMovedItem);
+      if (index < numberOfItems) {
+        LongEntry& entry = getEntry(index);
+        bool rowRedraw = fullRedraw || moved || entry.isModified() ||
+                         ((selection != previousSelection) && ((index == selection) || (index == previousSelection))) ||
+                         ((showGroupLetter != previousShowGroupLetter) && (index == selection));
 
-      // We have three lines left for the menu items
-      for (int i = 0; i < numberOfRowsUsedForItems; i++) {
-        display->setCursor(0, i + numberOfRows - numberOfRowsUsedForItems);
+        // Was the item invisible before or did it lose the selection?
+        if (forceRedraw || moved || (index < previousFirstVisibleItem) ||
+            (index >= previousFirstVisibleItem + numberOfRowsUsedForItems) ||
+            (animateSelectedOnly && (index == previousSelection) && (index != selection))) {
+          // Yes start the animation of the item from the beginning
+          entry.resetAnimation();
+        }
+        else if (!animateSelectedOnly || (index == selection)) {
+          // The animation must be updated if the next step is due
+          rowRedraw = entry.animationTick(maxLength, now, slowdown) || rowRedraw;
+        }
+
+        if (rowRedraw) {
+          display->setCursor(0, i + numberOfRows - numberOfRowsUsedForItems);
 
-        if (itEntry != menuItems.end()) {
-          // Is the item selected?
-          if (i == selection % numberOfRowsUsedForItems) {
-            display->print('>');
+          // Is the item selected or disabled?
+          if (index == selection) {
+            if (showGroupLetter) {
+              updateJumpIndex(numberOfItems);
+              display->print(jumpIndex.letterOf(index));
+            }
+            else {
+              display->print('>');
+            }
+          }
+          else if (!isItemEnabled(index)) {
+            display->print('-');
           }
           else {
             display->print(' ');
           }
 
-          // Is currently a new page displayed
-          if (fullRedraw) {
-            // Yes start the animation of the item from the beginning
-            itEntry->resetAnimation();
-          }
-          else if (animationTickRequired) {
-            // The animation must be updated
-            itEntry->animationTick(maxLength);
-          }
-
           // draw the menu item
-          itEntry->show(display, maxLength, fullRedraw);
-
-          // select the next menu item for the next iteration
-          itEntry++;
+          entry.show(display, maxLength, fullRedraw || moved || entry.isModified());
         }
-        else {
-          // Not enough items to be displayed, just clear the line
-          if (fullRedraw) {
-            for (size_t j = 0; j < maxLength + 1; j++) {
-              display->print(' ');
-            }
-          }
+      }
+      else if (fullRedraw || moved) {
+        // Not enough items to be displayed, just clear the line
+        display->setCursor(0, i + numberOfRows - numberOfRowsUsedForItems);
+        for (size_t j = 0; j < maxLength + 1; j++) {
+          display->print(' ');
         }
       }
     }
+    firstMovedItem = -1;
+
+    if (scrollbarShown) {
+      updateScrollbar(numberOfItems);
+    }
 
     // check if a menu entry was selected
-    if (encoderClicked) {
-      auto itEntry = menuItems.begin();
-      std::advance(itEntry, selection);
-      itEntry->callback(&*itEntry);
+    if ((event == InputEvent::select) && (selection < numberOfItems) && isItemEnabled(selection)) {
+      selectItem(selection);
+    }
+
+    // send the changed cells to the LCD
+    display->present();
+  }
+
+public:
+  /**
+   * @brief Sets how the visible items follow the selection
+   */
+  void setScrollMode(const ScrollMode& mode) {
+    scrollMode = mode;
+  }
+
+public:
+  /**
+   * @brief If set to true only the text of the selected item is animated.
+   * All other items show the beginning of their text.
+   */
+  void setAnimateSelectedOnly(const bool& selectedOnly) {
+    animateSelectedOnly = selectedOnly;
+  }
+
+public:
+  /**
+   * @brief If set to true press-and-turn jumps between the groups of items
+   * starting with the same letter instead of moving by one page, e.g. for
+   * long sorted lists. The marker of the selection shows the letter of its
+   * group after a jump.
+   */
+  void setQuickJump(const bool& enabled) {
+    quickJump = enabled;
+  }
+
+public:
+  /**
+   * @brief Must be called if texts of items changed while quick jumps are
+   * enabled. The groups are built again during the next jump.
+   */
+  void invalidateQuickJumpIndex() {
+    jumpIndex.invalidate();
+  }
+
+public:
+  /**
+   * @brief Stores the selection persistently, so it is restored as soon as
+   * the menu is activated, even after a reboot
+   *
+   * @param state the persistent state or nullptr to disable storing
+   * @param key the key of the stored selection
+   */
+  void setPersistentState(PersistentState* state, const uint8_t& key) {
+    persistentState = state;
+    persistentStateKey = key;
+  }
+
+public:
+  /**
+   * @brief Get the title of the menu, e.g. to configure its animation
+   */
+  LongEntry& getTitle() {
+    return title;
+  }
+
+protected:
+  /**
+   * @brief Returns the number of items
+   */
+  virtual int getNumberOfItems() {
+    return visibleItems.total();
+  }
+
+protected:
+  /**
+   * @brief Returns the entry showing an item. Only called for visible items.
+   *
+   * @param index index of the item
+   */
+  virtual LongEntry& getEntry(const int& index) {
+    MenuItem& item = menuItems[visibleItems.find(index)];
+    // texts of the string tables are only loaded for shown items
+    if ((item.textId != noText) && (item.textRevision != textRevision)) {
+      item.setText(StringTable::translate(item.textId));
+      item.textRevision = textRevision;
+    }
+    return item;
+  }
+
+protected:
+  /**
+   * @brief Returns the text of an item for the quick jump index. Unlike
+   * getEntry this can be called for items which are not visible.
+   *
+   * @param index index of the item
+   */
+  virtual String getItemText(const int& index) {
+    const MenuItem& item = menuItems[visibleItems.find(index)];
+    return item.textId != noText ? StringTable::translate(item.textId) : item.getText();
+  }
+
+protected:
+  /**
+   * @brief Called by tick if the current string table changed. Loads the
+   * title again, the items are loaded as soon as they are shown.
+   */
+  virtual void textsChanged() {
+    if (titleId != noText) {
+      title.setText(StringTable::translate(titleId));
     }
+    jumpIndex.invalidate();
+  }
+
+protected:
+  /**
+   * @brief Returns true if an item can be selected
+   *
+   * @param index index of the item
+   */
+  virtual bool isItemEnabled(const int& index) {
+    return menuItems[visibleItems.find(index)].enabled;
+  }
 
-    if (animationTickRequired) {
-      lastMillisForAnimationRefresh = millis();
+protected:
+  /**
+   * @brief Called as soon as an item is selected
+   *
+   * @param index index of the item
+   */
+  virtual void selectItem(const int& index) {
+    MenuItem& item = menuItems[visibleItems.find(index)];
+    item.callback(&item);
+  }
+
+protected:
+  /**
+   * @brief Called if the back event is not bound to an action. Activates the
+   * previous view.
+   *
+   * @return true if the menu was left
+   */
+  virtual bool goBack() {
+    if (!previousView) {
+      return false;
+    }
+    activatePreviousView();
+    return true;
+  }
+
+protected:
+  /**
+   * @brief Keeps press-and-turn which moves the selection by one page
+   */
+  virtual InputEvent translateInput(const InputEvent& event) {
+    if ((event == InputEvent::pressTurnUp) || (event == InputEvent::pressTurnDown)) {
+      return event;
+    }
+    return ViewBase::translateInput(event);
+  }
+
+protected:
+  /**
+   * @brief Returns the first enabled item starting at an item
+   *
+   * @param start index of the first checked item
+   * @param direction 1 to search downwards, -1 to search upwards
+   * @param numberOfItems number of items
+   * @return -1 if no enabled item was found
+   */
+  int findEnabledItem(int start, const int& direction, const int& numberOfItems) {
+    for (; (start >= 0) && (start < numberOfItems); start += direction) {
+      if (isItemEnabled(start)) {
+        return start;
+      }
+    }
+    return -1;
+  }
+
+protected:
+  /**
+   * @brief Moves the thumb of the scrollbar to the selection. The thumb is
+   * positioned with a resolution of one pixel row using generated special
+   * characters for the cells containing its ends. Only the cells whose part
+   * of the thumb changed are written. If LCD_FEATURE_GLYPHS is 0 the
+   * scrollbar is drawn with characters of the LCD's ROM in cell resolution.
+   */
+  void updateScrollbar(const int& numberOfItems) {
+    // on 2 row displays the scrollbar uses the row of the title
+    const int firstRow = numberOfRows == 2 ? 0 : numberOfRows - numberOfRowsUsedForItems;
+    const int trackPixels = (numberOfRows - firstRow) * 8;
+    const int length = std::max(trackPixels * numberOfRowsUsedForItems / std::max(numberOfItems, 1), 2);
+    const int start = numberOfItems > 1 ? (trackPixels - length) * selection / (numberOfItems - 1) : 0;
+    const int end = start + length;
+    if ((start == thumbStart) && (end == thumbEnd)) {
+      return;
+    }
+
+    for (int row = firstRow; row < numberOfRows; row++) {
+      const int top = (row - firstRow) * 8;
+      const int from = std::max(start, top);
+      const int to = std::min(end, top + 8);
+      if ((thumbStart >= 0) && (from == std::max(thumbStart, top)) && (to == std::min(thumbEnd, top + 8))) {
+        continue;
+      }
+
+#if LCD_FEATURE_GLYPHS
+      uint8_t character = scScrollbarMiddle;
+      if ((from == top) && (to == top + 8)) {
+        character = scScrollbarThumb;
+      }
+      else if (from < to) {
+        // only one cell can contain the upper end and one the lower end
+        character = from > top ? scScrollbarTop : scScrollbarBottom;
+        byte customChar[8];
+        for (int i = 0; i < 8; i++) {
+          customChar[i] = (top + i >= from) && (top + i < to) ? B11111 : B10001;
+        }
+        display->createChar(character, customChar);
+      }
+#else
+      // without special characters a cell shows the thumb if it is mostly
+      // covered or contains its center
+      const int center = (start + end) / 2;
+      const bool covered = (to - from >= 4) || ((center >= top) && (center < top + 8));
+      const uint8_t character = (from < to) && covered ? 0xFF : '|';
+#endif
+      display->setCursor(numberOfColumns - 1, row);
+      display->write(character);
+    }
+    thumbStart = start;
+    thumbEnd = end;
+  }
+
+protected:
+  /**
+   * @brief Builds the quick jump index if it is outdated
+   */
+  void updateJumpIndex(const int& numberOfItems) {
+    if (!jumpIndex.isValid(numberOfItems)) {
+      jumpIndex.build(numberOfItems, [this](const int& index) { return getItemText(index); });
+    }
+  }
+
+protected:
+  /**
+   * @brief Updates the visible index after an item was shown or hidden. The
+   * selection stays on the selected item or moves to the next item if the
+   * selected item was hidden.
+   *
+   * @param index index of the item in menuItems
+   * @param visible true if the item is shown now
+   */
+  void itemVisibilityChanged(const size_t& index, const bool& visible) {
+    const int position = visibleItems.prefixSum(index);
+    const int previousNumberOfItems = visibleItems.total();
+    visibleItems.add(index, visible ? 1 : -1);
+    jumpIndex.invalidate();
+
+    const int previousSelection = selection;
+    if (visible) {
+      if ((previousNumberOfItems != 0) && (selection >= position)) {
+        selection++;
+      }
+    }
+    else if (selection > position) {
+      selection--;
+    }
+    else if ((selection == position) && (selection + 1 >= previousNumberOfItems)) {
+      selection = std::max(selection - 1, 0);
+    }
+
+    if (persistentState && (selection != previousSelection)) {
+      persistentState->set(persistentStateKey, (int16_t)selection);
+    }
+
+    // all rows below the item show other items now
+    firstMovedItem = firstMovedItem < 0 ? position : std::min(firstMovedItem, position);
+  }
+
+protected:
+  /**
+   * @brief Updates firstVisibleItem so that the selection is visible
+   */
+  void updateFirstVisibleItem() {
+    if (scrollMode == ScrollMode::page) {
+      firstVisibleItem = selection - (selection % numberOfRowsUsedForItems);
+    }
+    else if (selection < firstVisibleItem) {
+      firstVisibleItem = selection;
+    }
+    else if (selection >= firstVisibleItem + numberOfRowsUsedForItems) {
+      firstVisibleItem = selection - numberOfRowsUsedForItems + 1;
     }
   }
 
@@ -437,7 +1365,32 @@ public:
     const String& text,
     const std::function<void(MenuItem*)>& callback = [](MenuItem* item) {}) {
     menuItems.push_back(MenuItem(text, callback));
+    menuItems.back().owner = this;
+    menuItems.back().index = menuItems.size() - 1;
+    visibleItems.append(1);
+    return menuItems.back();
+  }
+
+public:
+  /**
+   * @brief Add a new menu item whose text is read from the current string
+   * table as soon as it is shown
+   *
+   * @param text number of the text in the string tables
+   * @param callback callback as soon as the item is selected
+   * @return the new item
+   */
+  MenuItem& createMenuItem(
+    const TextId& text,
+    const std::function<void(MenuItem*)>& callback = [](MenuItem* item) {}) {
+    menuItems.push_back(MenuItem(text, callback));
+    menuItems.back().owner = this;
+    menuItems.back().index = menuItems.size() - 1;
+    visibleItems.append(1);
     return menuItems.back();
   }
 };
+
+LCD_ASSERT_SIZE(MenuView, LCD_BUDGET_MENU_VIEW);
+LCD_ASSERT_SIZE(MenuView::MenuItem, LCD_BUDGET_MENU_ITEM);
 } // namespace lcd
\ No newline at end of file
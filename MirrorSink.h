@@ -0,0 +1,228 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "DisplaySink.h"
+#include "Frame.h"
+
+#include <Arduino.h>
+
+namespace lcd {
+/**
+ * @brief Sink which forwards all changes to another sink and additionally
+ * streams them in a compact binary format, e.g. over Serial. Only the changes
+ * sent by Frame::present are transferred, so the bandwidth depends on the
+ * changes and not on the size of the display. tools/mirror_viewer.py
+ * reconstructs the screen on a PC.
+ *
+ * Every message starts with syncByte and ends with a checksum of the type
+ * and the data, so the viewer can skip other bytes on the stream and recover
+ * from lost bytes:
+ * syncByte, type, data, checksum
+ *
+ * Message types and their data:
+ * - 0x01: clear the display
+ * - 0x02 / 0x03: backlight off / on
+ * - 0x08 + slot, 8 bytes: bitmap of a special character
+ * - 0x10 + row, column, length, characters: run of characters
+ * - 0x80 + (row << 5) + column, length, characters: run of characters in the
+ *   rows 0..3 and the columns 0..31
+ *
+ * The viewer requests a complete transfer of the screen by sending
+ * resyncRequest, which is handled by tick.
+ *
+ * The stream must not be shared. tick only consumes resync requests, but
+ * another reader like a SerialInputSource swallows them. Other output, e.g.
+ * log messages, is skipped by the viewer, but it delays the changes and
+ * can cut a message, which is then repaired by the next resync.
+ *
+ * Example:
+ * @code
+ * lcd::LcdSink lcdSink(&display);
+ * lcd::MirrorSink mirror(&Serial, &lcdSink);
+ * void setup() {
+ *   ...
+ *   lcd::ViewBase::getFrame().setSink(&mirror);
+ * }
+ * void loop() {
+ *   mirror.tick(lcd::ViewBase::getFrame());
+ *   ...
+ * }
+ * @endcode
+ */
+class MirrorSink : public DisplaySink {
+public:
+  /**
+   * @brief Byte sent by the viewer to request a complete transfer (ENQ, not
+   * used by SerialInputSource)
+   */
+  const static uint8_t resyncRequest = 0x05;
+
+public:
+  /**
+   * @brief First byte of every message, not used by text output
+   */
+  const static uint8_t syncByte = 0xFE;
+
+public:
+  /**
+   * @brief Message types
+   */
+  enum Message : uint8_t {
+    clearMessage = 0x01,
+    backlightOffMessage = 0x02,
+    backlightOnMessage = 0x03,
+    glyphMessage = 0x08,
+    cellsMessage = 0x10,
+    shortCellsMessage = 0x80
+  };
+
+protected:
+  /**
+   * @brief Stream to which the changes are written
+   */
+  Stream* stream;
+
+protected:
+  /**
+   * @brief Sink to which the changes are forwarded, e.g. the LCD
+   */
+  DisplaySink* next;
+
+protected:
+  /**
+   * @brief If true changes are only accepted if the stream can take them
+   * without blocking
+   */
+  bool nonBlocking;
+
+protected:
+  /**
+   * @brief Checksum of the message which is currently written
+   */
+  uint8_t checksum;
+
+public:
+  /**
+   * @brief Construct a new mirror
+   *
+   * @param stream stream to which the changes are written
+   * @param next sink to which the changes are forwarded or nullptr
+   */
+  MirrorSink(Stream* stream, DisplaySink* next = nullptr)
+    : stream(stream)
+    , next(next)
+    , nonBlocking(false)
+    , checksum(0) {}
+
+public:
+  /**
+   * @brief If enabled the frame keeps its changes until the stream can take
+   * them without blocking. This requires a stream which implements
+   * availableForWrite, e.g. HardwareSerial.
+   */
+  void setNonBlocking(const bool& enabled) {
+    nonBlocking = enabled;
+  }
+
+public:
+  /**
+   * @brief Handles requests of the viewer. Must be called in the loop
+   * function.
+   *
+   * @param frame the frame which is flushed to this sink
+   */
+  void tick(Frame& frame) {
+    // other bytes are left for other readers of the stream
+    while ((stream->available() > 0) && (stream->peek() == resyncRequest)) {
+      stream->read();
+      frame.invalidate();
+    }
+  }
+
+public:
+  virtual bool canAccept(const size_t& operations) {
+    if (next && !next->canAccept(operations)) {
+      return false;
+    }
+    // the largest message is a run of LCD_FRAME_COLUMNS characters
+    return !nonBlocking || (stream->availableForWrite() >= (int)(operations * (5 + LCD_FRAME_COLUMNS)));
+  }
+
+public:
+  virtual void clear() {
+    if (next) {
+      next->clear();
+    }
+    beginMessage(clearMessage);
+    endMessage();
+  }
+
+public:
+  virtual void writeCells(const uint8_t& column, const uint8_t& row, const uint8_t* data, const uint8_t& length) {
+    if (next) {
+      next->writeCells(column, row, data, length);
+    }
+    if ((row < 4) && (column < 32)) {
+      beginMessage(shortCellsMessage | (row << 5) | column);
+    }
+    else {
+      beginMessage(cellsMessage | (row & 0x0F));
+      writeData(&column, 1);
+    }
+    writeData(&length, 1);
+    writeData(data, length);
+    endMessage();
+  }
+
+public:
+  virtual void createChar(const uint8_t& location, const uint8_t* charmap) {
+    if (next) {
+      next->createChar(location, charmap);
+    }
+    beginMessage(glyphMessage | (location & 0x07));
+    writeData(charmap, 8);
+    endMessage();
+  }
+
+public:
+  virtual void setBacklight(const bool& on) {
+    if (next) {
+      next->setBacklight(on);
+    }
+    beginMessage(on ? backlightOnMessage : backlightOffMessage);
+    endMessage();
+  }
+
+protected:
+  /**
+   * @brief Writes the sync byte and the type of a message
+   */
+  void beginMessage(const uint8_t& type) {
+    stream->write(syncByte);
+    checksum = 0xA5;
+    writeData(&type, 1);
+  }
+
+protected:
+  /**
+   * @brief Writes data of the current message
+   */
+  void writeData(const uint8_t* data, const uint8_t& length) {
+    stream->write(data, length);
+    for (uint8_t i = 0; i < length; i++) {
+      checksum = ((checksum << 1) | (checksum >> 7)) ^ data[i];
+    }
+  }
+
+protected:
+  /**
+   * @brief Writes the checksum of the current message
+   */
+  void endMessage() {
+    stream->write(checksum);
+  }
+};
+} // namespace lcd
@@ -0,0 +1,201 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Maximum number of display-columns supported by the frame buffer
+ */
+#ifndef LCD_FRAME_COLUMNS
+#define LCD_FRAME_COLUMNS 20
+#endif
+
+/**
+ * Maximum number of display-rows supported by the frame buffer
+ */
+#ifndef LCD_FRAME_ROWS
+#define LCD_FRAME_ROWS 4
+#endif
+
+namespace lcd {
+/**
+ * @brief Base class for a region of the display which is drawn on top of the
+ * active view, e.g. a status bar. The content is updated independently of the
+ * active view with its own interval.
+ */
+class Overlay {
+  friend class Frame;
+
+protected:
+  /**
+   * @brief First display-column covered by the overlay
+   */
+  const uint8_t column;
+
+protected:
+  /**
+   * @brief Display-row covered by the overlay
+   */
+  const uint8_t row;
+
+protected:
+  /**
+   * @brief Number of display-columns covered by the overlay
+   */
+  const uint8_t width;
+
+protected:
+  /**
+   * @brief Interval in milliseconds in which update is called
+   */
+  unsigned long interval;
+
+protected:
+  /**
+   * @brief millis value of the last update
+   */
+  uint32_t lastUpdate;
+
+protected:
+  /**
+   * @brief If true update has not been called yet
+   */
+  bool updatePending;
+
+protected:
+  /**
+   * @brief If true the content or the visibility changed since the last flush
+   */
+  bool changed;
+
+protected:
+  /**
+   * @brief If false the view below the overlay is shown
+   */
+  bool visible;
+
+protected:
+  /**
+   * @brief Content of the overlay
+   */
+  uint8_t cells[LCD_FRAME_COLUMNS];
+
+protected:
+  /**
+   * @brief Next overlay registered at the same frame
+   */
+  Overlay* nextOverlay;
+
+public:
+  /**
+   * @brief Construct a new overlay
+   *
+   * @param column first display-column covered by the overlay
+   * @param row display-row covered by the overlay
+   * @param width number of display-columns covered by the overlay
+   * @param interval interval in milliseconds in which the overlay is updated
+   */
+  Overlay(const uint8_t& column, const uint8_t& row, const uint8_t& width, const unsigned long& interval)
+    : column(column)
+    , row(row)
+    , width(column >= LCD_FRAME_COLUMNS           ? 0
+            : column + width <= LCD_FRAME_COLUMNS ? width
+                                                  : LCD_FRAME_COLUMNS - column)
+    , interval(interval)
+    , lastUpdate(0)
+    , updatePending(true)
+    , changed(true)
+    , visible(true)
+    , nextOverlay(nullptr) {
+    std::fill_n(cells, LCD_FRAME_COLUMNS, ' ');
+  }
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  Overlay(const Overlay& other) = delete;
+
+public:
+  /**
+   * @brief Destroy the overlay
+   */
+  virtual ~Overlay() {}
+
+public:
+  /**
+   * @brief Shows or hides the overlay
+   */
+  void setVisible(const bool& newVisible) {
+    if (visible != newVisible) {
+      visible = newVisible;
+      changed = true;
+    }
+  }
+
+public:
+  /**
+   * @brief Returns true if the overlay is drawn on top of the view
+   */
+  bool isVisible() const {
+    return visible;
+  }
+
+public:
+  /**
+   * @brief Requests an update during the next flush of the frame
+   */
+  void requestUpdate() {
+    updatePending = true;
+  }
+
+public:
+  /**
+   * @brief Sets the character of one cell of the overlay
+   *
+   * @param index index of the cell relative to the first column
+   * @param c the character code
+   */
+  void setCell(const uint8_t& index, const uint8_t& c) {
+    if ((index < width) && (cells[index] != c)) {
+      cells[index] = c;
+      changed = true;
+    }
+  }
+
+public:
+  /**
+   * @brief Sets the content of the overlay. Missing characters are filled
+   * with spaces.
+   */
+  void setText(const char* text) {
+    for (uint8_t i = 0; i < width; i++) {
+      setCell(i, *text ? *text++ : ' ');
+    }
+  }
+
+protected:
+  /**
+   * @brief Called by the frame as soon as the interval elapsed. Must update
+   * the content using setCell or setText.
+   */
+  virtual void update() = 0;
+
+protected:
+  /**
+   * @brief Calls update if necessary
+   *
+   * @param now the current millis value
+   */
+  void tick(const uint32_t& now) {
+    if (updatePending || (now - lastUpdate >= interval)) {
+      updatePending = false;
+      lastUpdate = now;
+      update();
+    }
+  }
+};
+} // namespace lcd
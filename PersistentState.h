@@ -0,0 +1,745 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Clock.h"
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_AVR)
+#include <EEPROM.h>
+#endif
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+#include <FS.h>
+#include <vector>
+#endif
+#if !defined(ARDUINO)
+#include <stdio.h>
+#include <vector>
+#endif
+
+/**
+ * Maximum number of values which can be stored
+ */
+#ifndef LCD_STATE_MAX_ENTRIES
+#define LCD_STATE_MAX_ENTRIES 16
+#endif
+
+/**
+ * Maximum size of one value in bytes
+ */
+#ifndef LCD_STATE_MAX_VALUE_SIZE
+#define LCD_STATE_MAX_VALUE_SIZE 4
+#endif
+
+namespace lcd {
+/**
+ * @brief Interface of a non volatile memory in which the state is stored
+ */
+class StorageBackend {
+public:
+  /**
+   * @brief Destroy the storage
+   */
+  virtual ~StorageBackend() {}
+
+public:
+  /**
+   * @brief Number of usable bytes
+   */
+  virtual size_t size() const = 0;
+
+public:
+  /**
+   * @brief Reads one byte
+   */
+  virtual uint8_t read(const size_t& address) = 0;
+
+public:
+  /**
+   * @brief Writes one byte. Implementations should skip the write if the byte
+   * already has the value.
+   */
+  virtual void write(const size_t& address, const uint8_t& value) = 0;
+
+public:
+  /**
+   * @brief Makes all written bytes persistent
+   */
+  virtual void commit() {}
+};
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_AVR)
+/**
+ * @brief Storage using the EEPROM (or the EEPROM emulation in flash)
+ *
+ * Only the AVR EEPROM writes single bytes. The EEPROM emulation of the
+ * ESP8266 and ESP32 erases and rewrites its whole flash sector on every
+ * commit, so there only the delayed commits of PersistentState reduce the
+ * wear. Use FsStorage on these boards instead.
+ */
+class EepromStorage : public StorageBackend {
+protected:
+  /**
+   * @brief First used address of the EEPROM
+   */
+  const size_t offset;
+
+protected:
+  /**
+   * @brief Number of used bytes
+   */
+  const size_t length;
+
+public:
+  /**
+   * @brief Construct a new storage
+   *
+   * @param offset first used address of the EEPROM
+   * @param length number of used bytes
+   */
+  EepromStorage(const size_t& offset, const size_t& length)
+    : offset(offset)
+    , length(length) {
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+    EEPROM.begin(offset + length);
+#endif
+  }
+
+public:
+  virtual size_t size() const {
+    return length;
+  }
+
+public:
+  virtual uint8_t read(const size_t& address) {
+    return EEPROM.read(offset + address);
+  }
+
+public:
+  virtual void write(const size_t& address, const uint8_t& value) {
+    if (EEPROM.read(offset + address) != value) {
+      EEPROM.write(offset + address, value);
+    }
+  }
+
+public:
+  virtual void commit() {
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+    EEPROM.commit();
+#endif
+  }
+};
+#endif
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+/**
+ * @brief Storage in a file of a flash file system, e.g. LittleFS. The file
+ * is kept in RAM and a commit only writes the range of changed bytes. The
+ * file system writes the changed data to other flash blocks, so the wear is
+ * spread over the whole file system.
+ *
+ * Example:
+ * @code
+ * LittleFS.begin();
+ * lcd::FsStorage storage(LittleFS, "/state.bin", 256);
+ * lcd::PersistentState state(&storage);
+ * @endcode
+ */
+class FsStorage : public StorageBackend {
+protected:
+  /**
+   * @brief The file system
+   */
+  fs::FS& fileSystem;
+
+protected:
+  /**
+   * @brief Path of the file
+   */
+  const String path;
+
+protected:
+  /**
+   * @brief Content of the file
+   */
+  std::vector<uint8_t> content;
+
+protected:
+  /**
+   * @brief First changed byte since the last commit
+   */
+  size_t firstModified;
+
+protected:
+  /**
+   * @brief Byte after the last changed byte since the last commit, 0 if
+   * nothing changed
+   */
+  size_t endModified;
+
+public:
+  /**
+   * @brief Reads the file. A missing file is created during the first commit.
+   *
+   * @param fileSystem the mounted file system
+   * @param path path of the file
+   * @param length number of usable bytes
+   */
+  FsStorage(fs::FS& fileSystem, const String& path, const size_t& length)
+    : fileSystem(fileSystem)
+    , path(path)
+    , content(length, 0xFF)
+    , firstModified(0)
+    , endModified(0) {
+    fs::File file = fileSystem.open(path, "r");
+    if (file) {
+      const size_t read = file.read(content.data(), length);
+      file.close();
+      if (read < length) {
+        // the file is extended during the next commit
+        firstModified = read;
+        endModified = length;
+      }
+    }
+    else {
+      endModified = length;
+    }
+  }
+
+public:
+  virtual size_t size() const {
+    return content.size();
+  }
+
+public:
+  virtual uint8_t read(const size_t& address) {
+    return content[address];
+  }
+
+public:
+  virtual void write(const size_t& address, const uint8_t& value) {
+    if (content[address] != value) {
+      content[address] = value;
+      firstModified = (endModified == 0) || (address < firstModified) ? address : firstModified;
+      endModified = address + 1 > endModified ? address + 1 : endModified;
+    }
+  }
+
+public:
+  virtual void commit() {
+    if (endModified == 0) {
+      return;
+    }
+    fs::File file = fileSystem.open(path, "r+");
+    if (!file) {
+      file = fileSystem.open(path, "w");
+      firstModified = 0;
+      endModified = content.size();
+    }
+    if (file && file.seek(firstModified)) {
+      file.write(content.data() + firstModified, endModified - firstModified);
+      firstModified = 0;
+      endModified = 0;
+    }
+    file.close();
+  }
+};
+#endif
+
+#if !defined(ARDUINO)
+/**
+ * @brief Storage in a file to use the persistent state on the host
+ */
+class FileStorage : public StorageBackend {
+protected:
+  /**
+   * @brief The opened file
+   */
+  FILE* file;
+
+protected:
+  /**
+   * @brief Content of the file
+   */
+  std::vector<uint8_t> content;
+
+public:
+  /**
+   * @brief Opens or creates the file
+   *
+   * @param path path of the file
+   * @param length number of usable bytes
+   */
+  FileStorage(const char* path, const size_t& length)
+    : file(fopen(path, "r+b"))
+    , content(length, 0xFF) {
+    if (file) {
+      content.resize(fread(content.data(), 1, length, file));
+      content.resize(length, 0xFF);
+    }
+    else {
+      file = fopen(path, "w+b");
+    }
+  }
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  FileStorage(const FileStorage& other) = delete;
+
+public:
+  /**
+   * @brief Closes the file
+   */
+  virtual ~FileStorage() {
+    if (file) {
+      fclose(file);
+    }
+  }
+
+public:
+  virtual size_t size() const {
+    return content.size();
+  }
+
+public:
+  virtual uint8_t read(const size_t& address) {
+    return content[address];
+  }
+
+public:
+  virtual void write(const size_t& address, const uint8_t& value) {
+    content[address] = value;
+  }
+
+public:
+  virtual void commit() {
+    if (file) {
+      fseek(file, 0, SEEK_SET);
+      fwrite(content.data(), 1, content.size(), file);
+      fflush(file);
+    }
+  }
+};
+#endif
+
+/**
+ * @brief Stores small values like menu selections persistently. The storage
+ * is split into two pages. Changed values are appended to the active page as
+ * records, so the same bytes are not rewritten on every change. If the page
+ * is full the current values are copied to the other page. Changes are
+ * collected in RAM and written together after commitDelay milliseconds.
+ *
+ * The append-only layout spreads the writes over the storage if single bytes
+ * can be written, e.g. in the AVR EEPROM. The EEPROM emulation of the
+ * ESP8266 and ESP32 rewrites its whole sector on every commit, so there only
+ * the collected commits help. FsStorage avoids this on these boards.
+ *
+ * Page layout: magic, sequence, inverted sequence followed by records of
+ * key, length, data and checksum. Unused bytes are 0xFF.
+ */
+class PersistentState {
+protected:
+  /**
+   * @brief One value cached in RAM
+   */
+  struct Entry {
+    uint8_t key;
+    uint8_t length;
+    bool modified;
+    uint8_t data[LCD_STATE_MAX_VALUE_SIZE];
+  };
+
+protected:
+  /**
+   * @brief First byte of a valid page
+   */
+  const static uint8_t pageMagic = 0x4C;
+
+protected:
+  /**
+   * @brief Size of the page header
+   */
+  const static size_t headerSize = 3;
+
+protected:
+  /**
+   * @brief Key marking unused bytes
+   */
+  const static uint8_t unusedKey = 0xFF;
+
+protected:
+  /**
+   * @brief The storage
+   */
+  StorageBackend* storage;
+
+protected:
+  /**
+   * @brief Number of milliseconds after the last change until the changes are
+   * written
+   */
+  const unsigned long commitDelay;
+
+protected:
+  /**
+   * @brief The cached values
+   */
+  Entry entries[LCD_STATE_MAX_ENTRIES];
+
+protected:
+  /**
+   * @brief Number of used entries
+   */
+  uint8_t numberOfEntries;
+
+protected:
+  /**
+   * @brief Index of the active page (0 or 1)
+   */
+  uint8_t activePage;
+
+protected:
+  /**
+   * @brief Sequence number of the active page
+   */
+  uint8_t sequence;
+
+protected:
+  /**
+   * @brief Offset within the active page at which the next record is written
+   */
+  size_t writePosition;
+
+protected:
+  /**
+   * @brief If true values were modified but not written yet
+   */
+  bool modified;
+
+protected:
+  /**
+   * @brief millis value of the last modification
+   */
+  uint32_t lastModification;
+
+public:
+  /**
+   * @brief Construct a new state
+   *
+   * @param storage the storage in which the values are stored
+   * @param commitDelay number of milliseconds after the last change until the
+   * changes are written
+   */
+  PersistentState(StorageBackend* storage, const unsigned long& commitDelay = 2000)
+    : storage(storage)
+    , commitDelay(commitDelay)
+    , numberOfEntries(0)
+    , activePage(0)
+    , sequence(0)
+    , writePosition(headerSize)
+    , modified(false)
+    , lastModification(0) {}
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  PersistentState(const PersistentState& other) = delete;
+
+public:
+  /**
+   * @brief Reads all values from the storage. Must be called once during
+   * setup before values are read.
+   */
+  void begin() {
+    numberOfEntries = 0;
+    modified = false;
+
+    // select the newest valid page
+    bool valid[2];
+    uint8_t sequences[2];
+    for (uint8_t page = 0; page < 2; page++) {
+      const size_t start = getPageStart(page);
+      sequences[page] = storage->read(start + 1);
+      valid[page] = (storage->read(start) == pageMagic) && (storage->read(start + 2) == (uint8_t)~sequences[page]);
+    }
+    if (!valid[0] && !valid[1]) {
+      activePage = 0;
+      sequence = 0;
+      formatPage(activePage, sequence);
+      storage->commit();
+      return;
+    }
+    activePage = (valid[0] && (!valid[1] || (int8_t)(sequences[0] - sequences[1]) > 0)) ? 0 : 1;
+    sequence = sequences[activePage];
+
+    // replay the records, later records replace earlier ones
+    const size_t start = getPageStart(activePage);
+    writePosition = headerSize;
+    while (writePosition + 3 <= getPageSize()) {
+      const uint8_t key = storage->read(start + writePosition);
+      const uint8_t length = storage->read(start + writePosition + 1);
+      if ((key == unusedKey) || (length > LCD_STATE_MAX_VALUE_SIZE) ||
+          (writePosition + 3 + length > getPageSize())) {
+        break;
+      }
+
+      uint8_t data[LCD_STATE_MAX_VALUE_SIZE];
+      uint8_t checksum = checksumStart(key, length);
+      for (uint8_t i = 0; i < length; i++) {
+        data[i] = storage->read(start + writePosition + 2 + i);
+        checksum = checksumAdd(checksum, data[i]);
+      }
+      if (storage->read(start + writePosition + 2 + length) != checksum) {
+        // interrupted write, the remaining page is rewritten
+        break;
+      }
+
+      Entry* entry = findEntry(key, true);
+      if (entry) {
+        entry->length = length;
+        std::copy(data, data + length, entry->data);
+      }
+      writePosition += 3 + length;
+    }
+  }
+
+public:
+  /**
+   * @brief Reads a value
+   *
+   * @param key the key of the value
+   * @param data receives the value
+   * @param length size of the value
+   * @return false if the value is not stored
+   */
+  bool get(const uint8_t& key, void* data, const uint8_t& length) const {
+    for (uint8_t i = 0; i < numberOfEntries; i++) {
+      if ((entries[i].key == key) && (entries[i].length == length)) {
+        std::copy(entries[i].data, entries[i].data + length, (uint8_t*)data);
+        return true;
+      }
+    }
+    return false;
+  }
+
+public:
+  /**
+   * @brief Reads a value
+   *
+   * @param key the key of the value
+   * @param value receives the value
+   * @return false if the value is not stored
+   */
+  template <typename T>
+  bool get(const uint8_t& key, T& value) const {
+    static_assert(sizeof(T) <= LCD_STATE_MAX_VALUE_SIZE, "value too large, increase LCD_STATE_MAX_VALUE_SIZE");
+    return get(key, &value, sizeof(T));
+  }
+
+public:
+  /**
+   * @brief Changes a value. The value is written after commitDelay
+   * milliseconds without further changes.
+   *
+   * @param key the key of the value (0..254)
+   * @param data the value
+   * @param length size of the value
+   */
+  void set(const uint8_t& key, const void* data, const uint8_t& length) {
+    if ((key == unusedKey) || (length > LCD_STATE_MAX_VALUE_SIZE)) {
+      return;
+    }
+    Entry* entry = findEntry(key, true);
+    if (!entry) {
+      return;
+    }
+    const uint8_t* bytes = (const uint8_t*)data;
+    if ((entry->length != length) || !std::equal(bytes, bytes + length, entry->data)) {
+      entry->length = length;
+      std::copy(bytes, bytes + length, entry->data);
+      entry->modified = true;
+      modified = true;
+      lastModification = Clock::get().millis();
+    }
+  }
+
+public:
+  /**
+   * @brief Changes a value. The value is written after commitDelay
+   * milliseconds without further changes.
+   *
+   * @param key the key of the value (0..254)
+   * @param value the value
+   */
+  template <typename T>
+  void set(const uint8_t& key, const T& value) {
+    static_assert(sizeof(T) <= LCD_STATE_MAX_VALUE_SIZE, "value too large, increase LCD_STATE_MAX_VALUE_SIZE");
+    set(key, &value, sizeof(T));
+  }
+
+public:
+  /**
+   * @brief Must be called in the loop function. Writes the changes as soon as
+   * no value changed for commitDelay milliseconds.
+   */
+  void tick() {
+    if (modified && (Clock::get().millis() - lastModification >= commitDelay)) {
+      commit();
+    }
+  }
+
+public:
+  /**
+   * @brief Writes all changes immediately
+   */
+  void commit() {
+    if (!modified) {
+      return;
+    }
+
+    for (uint8_t i = 0; i < numberOfEntries; i++) {
+      if (entries[i].modified) {
+        if (!appendRecord(entries[i])) {
+          // page is full, the new page contains all values
+          compact();
+          break;
+        }
+        entries[i].modified = false;
+      }
+    }
+    for (uint8_t i = 0; i < numberOfEntries; i++) {
+      entries[i].modified = false;
+    }
+    modified = false;
+    storage->commit();
+  }
+
+protected:
+  /**
+   * @brief Size of one page
+   */
+  size_t getPageSize() const {
+    return storage->size() / 2;
+  }
+
+protected:
+  /**
+   * @brief Address of the first byte of a page
+   */
+  size_t getPageStart(const uint8_t& page) const {
+    return page * getPageSize();
+  }
+
+protected:
+  /**
+   * @brief Searches the cached entry of a key
+   *
+   * @param key the key
+   * @param create if true a new entry is created if the key is unknown
+   */
+  Entry* findEntry(const uint8_t& key, const bool& create) {
+    for (uint8_t i = 0; i < numberOfEntries; i++) {
+      if (entries[i].key == key) {
+        return &entries[i];
+      }
+    }
+    if (!create || (numberOfEntries == LCD_STATE_MAX_ENTRIES)) {
+      return nullptr;
+    }
+    Entry& entry = entries[numberOfEntries++];
+    entry.key = key;
+    entry.length = 0;
+    entry.modified = false;
+    return &entry;
+  }
+
+protected:
+  /**
+   * @brief Initial value of a record checksum
+   */
+  static uint8_t checksumStart(const uint8_t& key, const uint8_t& length) {
+    return checksumAdd(checksumAdd(0xA5, key), length);
+  }
+
+protected:
+  /**
+   * @brief Adds a byte to a record checksum
+   */
+  static uint8_t checksumAdd(const uint8_t& checksum, const uint8_t& value) {
+    return ((checksum << 1) | (checksum >> 7)) ^ value;
+  }
+
+protected:
+  /**
+   * @brief Appends a record for an entry to the active page
+   *
+   * @return false if the page is full
+   */
+  bool appendRecord(const Entry& entry) {
+    if (writePosition + 3 + entry.length > getPageSize()) {
+      return false;
+    }
+    const size_t start = getPageStart(activePage) + writePosition;
+    uint8_t checksum = checksumStart(entry.key, entry.length);
+    storage->write(start + 1, entry.length);
+    for (uint8_t i = 0; i < entry.length; i++) {
+      storage->write(start + 2 + i, entry.data[i]);
+      checksum = checksumAdd(checksum, entry.data[i]);
+    }
+    storage->write(start + 2 + entry.length, checksum);
+    // the key is written last so an interrupted record is not used
+    storage->write(start, entry.key);
+    writePosition += 3 + entry.length;
+    return true;
+  }
+
+protected:
+  /**
+   * @brief Erases a page and writes its header
+   */
+  void formatPage(const uint8_t& page, const uint8_t& pageSequence) {
+    const size_t start = getPageStart(page);
+    for (size_t i = 0; i < getPageSize(); i++) {
+      storage->write(start + i, 0xFF);
+    }
+    storage->write(start + 1, pageSequence);
+    storage->write(start + 2, ~pageSequence);
+    storage->write(start, uint8_t(pageMagic));
+    writePosition = headerSize;
+  }
+
+protected:
+  /**
+   * @brief Copies all values to the other page and makes it the active one
+   */
+  void compact() {
+    const uint8_t oldPage = activePage;
+
+    // the header of the new page is written after all records, so an
+    // interrupted compaction keeps the old page valid
+    const size_t start = getPageStart(1 - oldPage);
+    for (size_t i = 0; i < getPageSize(); i++) {
+      storage->write(start + i, 0xFF);
+    }
+    activePage = 1 - oldPage;
+    writePosition = headerSize;
+    for (uint8_t i = 0; i < numberOfEntries; i++) {
+      appendRecord(entries[i]);
+    }
+    sequence++;
+    storage->write(start + 1, sequence);
+    storage->write(start + 2, ~sequence);
+    storage->write(start, uint8_t(pageMagic));
+    storage->commit();
+
+    // invalidate the old page
+    storage->write(getPageStart(oldPage), 0xFF);
+  }
+};
+} // namespace lcd
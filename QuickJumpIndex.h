@@ -0,0 +1,157 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <algorithm>
+#include <vector>
+
+namespace lcd {
+/**
+ * @brief Index of the groups of a list whose items start with the same
+ * letter. Consecutive items with the same first letter form one group, so a
+ * sorted list has one group per letter. The index only stores the first item
+ * of each group, i.e. at most a few dozen entries even for very long lists.
+ */
+class QuickJumpIndex {
+protected:
+  /**
+   * @brief One group of the index
+   */
+  struct Group {
+    /**
+     * @brief Index of the first item of the group
+     */
+    int first;
+
+    /**
+     * @brief Letter shared by the items of the group
+     */
+    char letter;
+  };
+
+protected:
+  /**
+   * @brief The groups sorted by their first item
+   */
+  std::vector<Group> groups;
+
+protected:
+  /**
+   * @brief Number of items covered by the index, -1 if it must be rebuilt
+   */
+  int numberOfItems;
+
+public:
+  /**
+   * @brief Construct an empty index
+   */
+  QuickJumpIndex()
+    : numberOfItems(-1) {}
+
+public:
+  /**
+   * @brief Returns the letter by which an item is grouped. Letters are
+   * grouped case insensitive, all other characters are grouped as '#'.
+   */
+  static char groupLetter(const String& text) {
+    if (text.length() == 0) {
+      return '#';
+    }
+    const char c = text[0];
+    if ((c >= 'a') && (c <= 'z')) {
+      return c - 'a' + 'A';
+    }
+    else if ((c >= 'A') && (c <= 'Z')) {
+      return c;
+    }
+    return '#';
+  }
+
+public:
+  /**
+   * @brief Marks the index as outdated, e.g. if texts changed
+   */
+  void invalidate() {
+    numberOfItems = -1;
+  }
+
+public:
+  /**
+   * @brief Returns true if the index covers the passed number of items
+   */
+  bool isValid(const int& items) const {
+    return numberOfItems == items;
+  }
+
+public:
+  /**
+   * @brief Rebuilds the index
+   *
+   * @param items number of items
+   * @param getText returns the text of an item
+   */
+  template <typename TextFunction>
+  void build(const int& items, TextFunction getText) {
+    groups.clear();
+    for (int i = 0; i < items; i++) {
+      const char letter = groupLetter(getText(i));
+      if (groups.empty() || (groups.back().letter != letter)) {
+        groups.push_back({i, letter});
+      }
+    }
+    groups.shrink_to_fit();
+    numberOfItems = items;
+  }
+
+public:
+  /**
+   * @brief Returns the letter of the group containing an item
+   */
+  char letterOf(const int& index) const {
+    const size_t group = groupOf(index);
+    return group < groups.size() ? groups[group].letter : ' ';
+  }
+
+public:
+  /**
+   * @brief Returns the first item of the next group or -1 if the item is in
+   * the last group
+   */
+  int next(const int& index) const {
+    const size_t group = groupOf(index) + 1;
+    return group < groups.size() ? groups[group].first : -1;
+  }
+
+public:
+  /**
+   * @brief Returns the first item of the group containing an item or, if the
+   * item is the first of its group, the first item of the previous group.
+   * Returns -1 if the item is the first item of the list.
+   */
+  int previous(const int& index) const {
+    const size_t group = groupOf(index);
+    if (group >= groups.size()) {
+      return -1;
+    }
+    else if (groups[group].first < index) {
+      return groups[group].first;
+    }
+    return group > 0 ? groups[group - 1].first : -1;
+  }
+
+protected:
+  /**
+   * @brief Returns the index of the group containing an item, the size of
+   * groups if the index is empty
+   */
+  size_t groupOf(const int& index) const {
+    auto it = std::upper_bound(groups.begin(), groups.end(), index, [](const int& value, const Group& group) {
+      return value < group.first;
+    });
+    return it == groups.begin() ? groups.size() : it - groups.begin() - 1;
+  }
+};
+} // namespace lcd
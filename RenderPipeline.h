@@ -0,0 +1,352 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_ESP32) || !defined(ARDUINO)
+
+#include "DisplaySink.h"
+#include "Overlay.h"
+#include "SpscQueue.h"
+
+#include <LiquidCrystal_PCF8574.h>
+#include <atomic>
+
+#ifndef ARDUINO
+#include <chrono>
+#include <thread>
+#endif
+
+/**
+ * Number of commands which can be queued between the loop and the render task
+ */
+#ifndef LCD_RENDER_QUEUE_SIZE
+#define LCD_RENDER_QUEUE_SIZE 16
+#endif
+
+/**
+ * Stack size of the render task in bytes (ESP32 only)
+ */
+#ifndef LCD_RENDER_TASK_STACK_SIZE
+#define LCD_RENDER_TASK_STACK_SIZE 2048
+#endif
+
+/**
+ * Priority of the render task (ESP32 only)
+ */
+#ifndef LCD_RENDER_TASK_PRIORITY
+#define LCD_RENDER_TASK_PRIORITY 1
+#endif
+
+namespace lcd {
+/**
+ * @brief One change posted to the render task
+ */
+struct RenderCommand {
+  /**
+   * @brief Type of the change
+   */
+  enum class Type : uint8_t { clear, cells, glyph, backlight };
+
+  /**
+   * @brief Type of the change
+   */
+  Type type;
+
+  /**
+   * @brief First display-column of a run, slot of a special character or
+   * state of the backlight
+   */
+  uint8_t column;
+
+  /**
+   * @brief Display-row of a run
+   */
+  uint8_t row;
+
+  /**
+   * @brief Number of valid bytes in data
+   */
+  uint8_t length;
+
+  /**
+   * @brief Characters of a run or bitmap of a special character
+   */
+  uint8_t data[LCD_FRAME_COLUMNS > 8 ? LCD_FRAME_COLUMNS : 8];
+};
+
+/**
+ * @brief Optional sink which moves the I2C communication into a separate task
+ * (ESP32) or thread (host builds). Frame::present posts its changes to a
+ * lock-free queue and returns immediately. If the queue is full the frame
+ * keeps the remaining changes and sends the newest content during one of the
+ * next flushes, so a slow display skips intermediate states instead of
+ * delaying the loop.
+ *
+ * After begin was called the LCD must only be accessed by the pipeline.
+ *
+ * Example:
+ * @code
+ * lcd::RenderPipeline pipeline(&display);
+ * void setup() {
+ *   ...
+ *   pipeline.begin(0);
+ *   lcd::ViewBase::getFrame().setSink(&pipeline);
+ * }
+ * @endcode
+ */
+class RenderPipeline : public DisplaySink {
+protected:
+  /**
+   * @brief Sink used by the render task to write to the LCD
+   */
+  LcdSink output;
+
+protected:
+  /**
+   * @brief Commands posted by the frame
+   */
+  SpscQueue<RenderCommand, LCD_RENDER_QUEUE_SIZE> queue;
+
+protected:
+  /**
+   * @brief True while the render task should keep running
+   */
+  std::atomic<bool> running;
+
+protected:
+  /**
+   * @brief Number of flushes which were deferred because the queue was full
+   */
+  std::atomic<unsigned long> deferredFlushes;
+
+#ifdef ARDUINO
+protected:
+  /**
+   * @brief Handle of the render task
+   */
+  TaskHandle_t task;
+
+protected:
+  /**
+   * @brief Set by the render task right before it deletes itself
+   */
+  std::atomic<bool> taskStopped;
+#else
+protected:
+  /**
+   * @brief Thread emulating the render task
+   */
+  std::thread task;
+#endif
+
+public:
+  /**
+   * @brief Construct a new pipeline. The render task is started by begin.
+   *
+   * @param display pointer to the LCD instance
+   */
+  RenderPipeline(LiquidCrystal_PCF8574* display)
+    : output(display)
+    , running(false)
+    , deferredFlushes(0)
+#ifdef ARDUINO
+    , task(nullptr)
+    , taskStopped(false)
+#endif
+  {
+  }
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  RenderPipeline(const RenderPipeline& other) = delete;
+
+public:
+  /**
+   * @brief Stops the render task
+   */
+  virtual ~RenderPipeline() {
+    end();
+  }
+
+public:
+  /**
+   * @brief Starts the render task
+   *
+   * @param core core on which the task runs (ESP32 only). Should differ from
+   * the core of the loop function.
+   */
+  void begin(const int& core = 0) {
+    if (running.exchange(true)) {
+      return;
+    }
+#ifdef ARDUINO
+    taskStopped = false;
+    xTaskCreatePinnedToCore(&RenderPipeline::taskFunction, "lcd", LCD_RENDER_TASK_STACK_SIZE, this,
+                            LCD_RENDER_TASK_PRIORITY, &task, core);
+#else
+    task = std::thread(&RenderPipeline::taskFunction, this);
+#endif
+  }
+
+public:
+  /**
+   * @brief Stops the render task after the queued commands were written
+   */
+  void end() {
+    if (!running.exchange(false)) {
+      return;
+    }
+#ifdef ARDUINO
+    xTaskNotifyGive(task);
+    // the task deletes itself
+    while (!taskStopped.load(std::memory_order_acquire)) {
+      delay(1);
+    }
+    task = nullptr;
+#else
+    task.join();
+#endif
+  }
+
+public:
+  /**
+   * @brief Writes queued commands to the LCD. Called by the render task, but
+   * can also be called from the loop function if begin was not called.
+   *
+   * @param maxCommands maximum number of commands to write, 0 for all
+   * @return number of written commands
+   */
+  size_t process(const size_t& maxCommands = 0) {
+    size_t count = 0;
+    while ((maxCommands == 0) || (count < maxCommands)) {
+      const RenderCommand* command = queue.front();
+      if (!command) {
+        break;
+      }
+      switch (command->type) {
+      case RenderCommand::Type::clear:
+        output.clear();
+        break;
+      case RenderCommand::Type::cells:
+        output.writeCells(command->column, command->row, command->data, command->length);
+        break;
+      case RenderCommand::Type::glyph:
+        output.createChar(command->column, command->data);
+        break;
+      case RenderCommand::Type::backlight:
+        output.setBacklight(command->column != 0);
+        break;
+      }
+      queue.pop();
+      count++;
+    }
+    return count;
+  }
+
+public:
+  /**
+   * @brief Number of commands waiting for the render task
+   */
+  size_t pending() const {
+    return queue.size();
+  }
+
+public:
+  /**
+   * @brief Number of times the frame had to keep changes because the queue
+   * was full
+   */
+  unsigned long getDeferredFlushes() const {
+    return deferredFlushes.load(std::memory_order_relaxed);
+  }
+
+public:
+  virtual bool canAccept(const size_t& operations) {
+    if (queue.free() < operations) {
+      deferredFlushes.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+public:
+  virtual void clear() {
+    RenderCommand command;
+    command.type = RenderCommand::Type::clear;
+    post(command);
+  }
+
+public:
+  virtual void writeCells(const uint8_t& column, const uint8_t& row, const uint8_t* data, const uint8_t& length) {
+    RenderCommand command;
+    command.type = RenderCommand::Type::cells;
+    command.column = column;
+    command.row = row;
+    command.length = length < sizeof(command.data) ? length : sizeof(command.data);
+    std::copy(data, data + command.length, command.data);
+    post(command);
+  }
+
+public:
+  virtual void createChar(const uint8_t& location, const uint8_t* charmap) {
+    RenderCommand command;
+    command.type = RenderCommand::Type::glyph;
+    command.column = location;
+    command.length = 8;
+    std::copy(charmap, charmap + 8, command.data);
+    post(command);
+  }
+
+public:
+  virtual void setBacklight(const bool& on) {
+    RenderCommand command;
+    command.type = RenderCommand::Type::backlight;
+    command.column = on ? 1 : 0;
+    post(command);
+  }
+
+protected:
+  /**
+   * @brief Adds a command to the queue and wakes up the render task. The
+   * frame checked the free space before using canAccept.
+   */
+  void post(const RenderCommand& command) {
+    queue.push(command);
+#ifdef ARDUINO
+    if (task) {
+      xTaskNotifyGive(task);
+    }
+#endif
+  }
+
+protected:
+  /**
+   * @brief Main function of the render task
+   */
+  static void taskFunction(void* parameter) {
+    RenderPipeline* pipeline = (RenderPipeline*)parameter;
+    while (pipeline->running.load(std::memory_order_acquire)) {
+      if (pipeline->process() == 0) {
+#ifdef ARDUINO
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+      }
+    }
+    pipeline->process();
+#ifdef ARDUINO
+    pipeline->taskStopped.store(true, std::memory_order_release);
+    vTaskDelete(nullptr);
+#endif
+  }
+};
+} // namespace lcd
+
+#endif
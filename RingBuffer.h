@@ -0,0 +1,162 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <stddef.h>
+
+namespace lcd {
+/**
+ * @brief Fixed size first-in-first-out buffer which does not use the heap.
+ *
+ * @tparam T type of the stored elements
+ * @tparam N maximum number of stored elements
+ */
+template <typename T, size_t N>
+class RingBuffer {
+  static_assert(N > 0, "RingBuffer must be able to store at least one element");
+
+protected:
+  /**
+   * @brief Storage of the elements
+   */
+  T elements[N];
+
+protected:
+  /**
+   * @brief Index of the oldest element
+   */
+  size_t head;
+
+protected:
+  /**
+   * @brief Number of stored elements
+   */
+  size_t count;
+
+public:
+  /**
+   * @brief Construct an empty buffer
+   */
+  RingBuffer()
+    : elements()
+    , head(0)
+    , count(0) {}
+
+public:
+  /**
+   * @brief Maximum number of elements which can be stored
+   */
+  static constexpr size_t capacity() {
+    return N;
+  }
+
+public:
+  /**
+   * @brief Number of stored elements
+   */
+  size_t size() const {
+    return count;
+  }
+
+public:
+  /**
+   * @brief Number of elements which can still be pushed
+   */
+  size_t free() const {
+    return N - count;
+  }
+
+public:
+  /**
+   * @brief Returns true if no element is stored
+   */
+  bool empty() const {
+    return count == 0;
+  }
+
+public:
+  /**
+   * @brief Returns true if no further element can be pushed
+   */
+  bool full() const {
+    return count == N;
+  }
+
+public:
+  /**
+   * @brief Removes all elements
+   */
+  void clear() {
+    head = 0;
+    count = 0;
+  }
+
+public:
+  /**
+   * @brief Appends an element
+   *
+   * @param value the element to append
+   * @return false if the buffer is full and the element was dropped
+   */
+  bool push(const T& value) {
+    if (full()) {
+      return false;
+    }
+    elements[(head + count) % N] = value;
+    count++;
+    return true;
+  }
+
+public:
+  /**
+   * @brief Appends an element. If the buffer is full the oldest element is
+   * overwritten.
+   *
+   * @param value the element to append
+   */
+  void pushOverwrite(const T& value) {
+    if (full()) {
+      elements[head] = value;
+      head = (head + 1) % N;
+    }
+    else {
+      push(value);
+    }
+  }
+
+public:
+  /**
+   * @brief Removes the oldest element
+   *
+   * @param value receives the removed element
+   * @return false if the buffer was empty
+   */
+  bool pop(T& value) {
+    if (empty()) {
+      return false;
+    }
+    value = elements[head];
+    head = (head + 1) % N;
+    count--;
+    return true;
+  }
+
+public:
+  /**
+   * @brief Access an element. Index 0 is the oldest element.
+   */
+  T& operator[](const size_t& index) {
+    return elements[(head + index) % N];
+  }
+
+public:
+  /**
+   * @brief Access an element. Index 0 is the oldest element.
+   */
+  const T& operator[](const size_t& index) const {
+    return elements[(head + index) % N];
+  }
+};
+} // namespace lcd
@@ -0,0 +1,365 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Config.h"
+#include "RingBuffer.h"
+#include "ViewBase.h"
+
+#include <Arduino.h>
+#include <RotaryEncoder.h>
+
+#if !LCD_FEATURE_GLYPHS
+#error "SparklineView needs special characters, LCD_FEATURE_GLYPHS is 0"
+#endif
+
+namespace lcd {
+/**
+ * @brief View showing the trend of a value as a chart drawn with up to 8
+ * special characters. Every special character shows 5 columns of the chart.
+ * If more samples are stored than columns are available they are averaged.
+ * A click activates the previous view.
+ *
+ * @tparam N number of stored samples
+ */
+template <size_t N>
+class SparklineView : public ViewBase {
+public:
+  /**
+   * @brief Number of pixel columns of one special character
+   */
+  const static uint8_t columnsPerCharacter = 5;
+
+protected:
+  /**
+   * @brief pointer to the encoder instance
+   */
+  RotaryEncoder* encoder;
+
+protected:
+  /**
+   * @brief Text shown above the chart
+   */
+  const String caption;
+
+protected:
+  /**
+   * @brief The stored samples
+   */
+  RingBuffer<float, N> samples;
+
+protected:
+  /**
+   * @brief Number of special characters used for the chart
+   */
+  const uint8_t numberOfCharacters;
+
+protected:
+  /**
+   * @brief If true minimum and maximum are calculated from the samples
+   */
+  bool autoScale;
+
+protected:
+  /**
+   * @brief Value shown at the bottom of the chart
+   */
+  float minimum;
+
+protected:
+  /**
+   * @brief Value shown at the top of the chart
+   */
+  float maximum;
+
+protected:
+  /**
+   * @brief Height of each column of the chart in pixels (0..8)
+   */
+  uint8_t heights[8 * columnsPerCharacter];
+
+protected:
+  /**
+   * @brief Bitmaps of the special characters as they were uploaded
+   */
+  uint8_t bitmaps[8][8];
+
+protected:
+  /**
+   * @brief If true the special characters must be updated
+   */
+  bool chartModified;
+
+protected:
+  /**
+   * @brief If true the caption row must be redrawn
+   */
+  bool captionModified;
+
+public:
+  /**
+   * @brief Number of display-columns
+   */
+  const int numberOfColumns;
+
+public:
+  /**
+   * @brief Number of display-rows
+   */
+  const int numberOfRows;
+
+public:
+  /**
+   * @brief Construct a new view
+   *
+   * @param display pointer to the display instance
+   * @param name The name of the view
+   * @param encoder pointer to the encoder instance
+   * @param caption text shown in front of the latest value
+   * @param numberOfColumns number of display-columns
+   * @param numberOfRows number of display-rows
+   * @param numberOfCharacters number of special characters used for the chart
+   * (1..8)
+   */
+  SparklineView(LiquidCrystal_PCF8574* display,
+                const String& name,
+                RotaryEncoder* encoder,
+                const String& caption,
+                const int& numberOfColumns,
+                const int& numberOfRows,
+                const uint8_t& numberOfCharacters = 8)
+    : ViewBase(display, name)
+    , encoder(encoder)
+    , caption(caption)
+    , numberOfCharacters(numberOfCharacters < 1 ? 1 : (numberOfCharacters > 8 ? 8 : numberOfCharacters))
+    , autoScale(true)
+    , minimum(0)
+    , maximum(0)
+    , chartModified(true)
+    , captionModified(true)
+    , numberOfColumns(numberOfColumns)
+    , numberOfRows(numberOfRows) {
+    std::fill_n(heights, 8 * columnsPerCharacter, 0);
+    for (auto& bitmap : bitmaps) {
+      std::fill_n(bitmap, 8, 0);
+    }
+    ViewBase::display->setSize(numberOfColumns, numberOfRows);
+    getInput().useEncoder(encoder);
+    // the samples are excluded, their number is chosen by the application
+    static_assert((LCD_BUDGET_SPARKLINE_VIEW == 0) || (sizeof(SparklineView) - sizeof(RingBuffer<float, N>) <= LCD_BUDGET_SPARKLINE_VIEW),
+                  "SparklineView exceeds LCD_BUDGET_SPARKLINE_VIEW, see Config.h");
+  }
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  SparklineView(const SparklineView& other) = delete;
+
+public:
+  /**
+   * @brief Uses a fixed range instead of calculating it from the samples
+   */
+  void setRange(const float& minimum, const float& maximum) {
+    autoScale = false;
+    this->minimum = minimum;
+    this->maximum = maximum;
+    recalculateHeights();
+  }
+
+public:
+  /**
+   * @brief Adds a new sample. If the scale does not change the columns of
+   * the chart are only shifted by one.
+   */
+  void addSample(const float& value) {
+    const bool sampleDropped = samples.full();
+    samples.pushOverwrite(value);
+    captionModified = true;
+
+    const float oldMinimum = minimum;
+    const float oldMaximum = maximum;
+    if (autoScale) {
+      minimum = maximum = samples[0];
+      for (size_t i = 1; i < samples.size(); i++) {
+        minimum = samples[i] < minimum ? samples[i] : minimum;
+        maximum = samples[i] > maximum ? samples[i] : maximum;
+      }
+    }
+
+    const size_t numberOfChartColumns = numberOfCharacters * columnsPerCharacter;
+    if ((samples.size() <= numberOfChartColumns) && (!sampleDropped || (N >= numberOfChartColumns)) &&
+        (oldMinimum == minimum) && (oldMaximum == maximum)) {
+      // one sample per column and unchanged scale: just shift the columns
+      std::copy(heights + 1, heights + numberOfChartColumns, heights);
+      heights[numberOfChartColumns - 1] = getHeight(value);
+      chartModified = true;
+    }
+    else {
+      recalculateHeights();
+    }
+  }
+
+public:
+  /**
+   * @brief Get the stored samples, index 0 is the oldest one
+   */
+  const RingBuffer<float, N>& getSamples() const {
+    return samples;
+  }
+
+protected:
+  /**
+   * @brief called as soon as the view becomes active
+   */
+  virtual void activate() {
+    display->clear();
+    display->setCursor(0, numberOfRows > 1 ? 1 : 0);
+    for (uint8_t i = 0; i < numberOfCharacters; i++) {
+      display->write(i);
+    }
+
+    // the special characters of other views were uploaded in between
+    for (uint8_t i = 0; i < numberOfCharacters; i++) {
+      display->createChar(i, bitmaps[i]);
+    }
+    captionModified = true;
+    tick(true);
+  }
+
+public:
+  /**
+   * @brief called during the loop function
+   *
+   * @param forceRedraw if true everything should be redrawn
+   */
+  virtual void tick(const bool& forceRedraw) {
+    const InputEvent event = readInput();
+
+    // Update the backlight timeout
+    if (event != InputEvent::none) {
+      if (!getBacklightTimeoutManager().delayTimeout()) {
+        getBacklightTimeoutManager().tick(display);
+        display->present();
+        return;
+      }
+    }
+    getBacklightTimeoutManager().tick(display);
+
+    if ((event == InputEvent::select) || (event == InputEvent::back)) {
+      activatePreviousView();
+      return;
+    }
+
+    if (chartModified || forceRedraw) {
+      updateCharacters();
+    }
+
+    if ((captionModified || forceRedraw) && (numberOfRows > 1)) {
+      drawCaption();
+    }
+
+    // send the changed cells to the LCD
+    display->present();
+  }
+
+protected:
+  /**
+   * @brief Converts a value to the height of a column (1..8)
+   */
+  uint8_t getHeight(const float& value) const {
+    if (maximum <= minimum) {
+      return 4;
+    }
+    const int height = 1 + (int)((value - minimum) * 7 / (maximum - minimum) + 0.5f);
+    return height < 1 ? 1 : (height > 8 ? 8 : height);
+  }
+
+protected:
+  /**
+   * @brief Recalculates all columns of the chart from the samples. The newest
+   * sample is shown in the right column.
+   */
+  void recalculateHeights() {
+    const size_t numberOfChartColumns = numberOfCharacters * columnsPerCharacter;
+    const size_t count = samples.size();
+    std::fill_n(heights, numberOfChartColumns, 0);
+
+    if (count <= numberOfChartColumns) {
+      for (size_t i = 0; i < count; i++) {
+        heights[numberOfChartColumns - count + i] = getHeight(samples[i]);
+      }
+    }
+    else {
+      // average the samples of each column
+      for (size_t column = 0; column < numberOfChartColumns; column++) {
+        const size_t first = column * count / numberOfChartColumns;
+        const size_t last = (column + 1) * count / numberOfChartColumns;
+        float sum = 0;
+        for (size_t i = first; i < last; i++) {
+          sum += samples[i];
+        }
+        heights[column] = getHeight(sum / (last - first));
+      }
+    }
+    chartModified = true;
+  }
+
+protected:
+  /**
+   * @brief Rebuilds the bitmaps of the special characters and uploads the
+   * ones which changed. A changed character is uploaded with all its 8 rows,
+   * because createChar of the LCD library cannot write single CGRAM rows.
+   */
+  void updateCharacters() {
+    for (uint8_t character = 0; character < numberOfCharacters; character++) {
+      uint8_t bitmap[8];
+      for (uint8_t row = 0; row < 8; row++) {
+        bitmap[row] = 0;
+        for (uint8_t column = 0; column < columnsPerCharacter; column++) {
+          if (heights[character * columnsPerCharacter + column] >= 8 - row) {
+            bitmap[row] |= 0x10 >> column;
+          }
+        }
+      }
+      if (!std::equal(bitmap, bitmap + 8, bitmaps[character])) {
+        std::copy(bitmap, bitmap + 8, bitmaps[character]);
+        display->createChar(character, bitmap);
+      }
+    }
+    chartModified = false;
+  }
+
+protected:
+  /**
+   * @brief Draws the caption and the latest value. If both do not fit, the
+   * end of the caption is cut so the value stays visible.
+   */
+  void drawCaption() {
+    display->setCursor(0, 0);
+    String value;
+    if (!samples.empty()) {
+      const float latest = samples[samples.size() - 1];
+      const long tenths = (long)(latest * 10 + (latest < 0 ? -0.5f : 0.5f));
+      const long magnitude = tenths < 0 ? -tenths : tenths;
+      // long: int has only 16 bits on AVR
+      value = String(tenths < 0 ? "-" : "") + String(magnitude / 10) + "." + String(magnitude % 10);
+    }
+    const int captionLength = std::min((int)caption.length(), std::max(numberOfColumns - (int)value.length(), 0));
+    for (int i = 0; i < numberOfColumns; i++) {
+      if (i < captionLength) {
+        display->print(caption[i]);
+      }
+      else if (i - captionLength < (int)value.length()) {
+        display->print(value[i - captionLength]);
+      }
+      else {
+        display->print(' ');
+      }
+    }
+    captionModified = false;
+  }
+};
+} // namespace lcd
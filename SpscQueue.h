@@ -0,0 +1,139 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+
+namespace lcd {
+/**
+ * @brief Fixed size first-in-first-out queue which can be used without locks
+ * by exactly one producer and one consumer running on different cores. Only
+ * the producer may call push and only the consumer may call front and pop.
+ *
+ * @tparam T type of the stored elements
+ * @tparam N maximum number of stored elements
+ */
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N > 0, "SpscQueue must be able to store at least one element");
+
+protected:
+  /**
+   * @brief Storage of the elements. One additional slot distinguishes a full
+   * from an empty queue.
+   */
+  T elements[N + 1];
+
+protected:
+  /**
+   * @brief Index of the oldest element, only written by the consumer
+   */
+  std::atomic<size_t> head;
+
+protected:
+  /**
+   * @brief Index of the next free slot, only written by the producer
+   */
+  std::atomic<size_t> tail;
+
+public:
+  /**
+   * @brief Construct an empty queue
+   */
+  SpscQueue()
+    : elements()
+    , head(0)
+    , tail(0) {}
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  SpscQueue(const SpscQueue& other) = delete;
+
+public:
+  /**
+   * @brief Maximum number of elements which can be stored
+   */
+  static constexpr size_t capacity() {
+    return N;
+  }
+
+public:
+  /**
+   * @brief Number of stored elements. Only a snapshot if the other side is
+   * running concurrently.
+   */
+  size_t size() const {
+    const size_t h = head.load(std::memory_order_acquire);
+    const size_t t = tail.load(std::memory_order_acquire);
+    return t >= h ? t - h : t + N + 1 - h;
+  }
+
+public:
+  /**
+   * @brief Number of elements which can still be pushed. Since the consumer
+   * only removes elements the producer can rely on this number.
+   */
+  size_t free() const {
+    return N - size();
+  }
+
+public:
+  /**
+   * @brief Returns true if no element is stored
+   */
+  bool empty() const {
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+  }
+
+public:
+  /**
+   * @brief Adds an element (producer only)
+   *
+   * @return false if the queue is full
+   */
+  bool push(const T& element) {
+    const size_t t = tail.load(std::memory_order_relaxed);
+    const size_t next = t == N ? 0 : t + 1;
+    if (next == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    elements[t] = element;
+    tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+public:
+  /**
+   * @brief Get the oldest element without removing it (consumer only)
+   *
+   * @return nullptr if the queue is empty
+   */
+  const T* front() const {
+    const size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &elements[h];
+  }
+
+public:
+  /**
+   * @brief Removes the oldest element (consumer only)
+   *
+   * @return false if the queue was empty
+   */
+  bool pop() {
+    const size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    head.store(h == N ? 0 : h + 1, std::memory_order_release);
+    return true;
+  }
+};
+} // namespace lcd
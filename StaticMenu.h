@@ -0,0 +1,411 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "MenuView.h"
+
+#include <Arduino.h>
+#include <RotaryEncoder.h>
+
+/**
+ * Maximum number of nested submenus of a StaticMenuView
+ */
+#ifndef LCD_STATIC_MENU_DEPTH
+#define LCD_STATIC_MENU_DEPTH 4
+#endif
+
+namespace lcd {
+/**
+ * @brief One item of a menu defined at compile time
+ */
+struct StaticMenuEntry {
+  /**
+   * @brief What happens if the item is selected
+   */
+  enum class Type : uint8_t { action, link, back };
+
+  /**
+   * @brief Text of the item, nullptr if textId is used
+   */
+  const char* text;
+
+  /**
+   * @brief What happens if the item is selected
+   */
+  Type type;
+
+  /**
+   * @brief Index of the submenu opened by a link
+   */
+  uint8_t target;
+
+  /**
+   * @brief Function called by an action
+   */
+  void (*action)();
+
+  /**
+   * @brief Number of the text in the string tables, used if text is nullptr
+   */
+  TextId textId;
+};
+
+/**
+ * @brief A menu defined at compile time
+ */
+struct StaticMenu {
+  /**
+   * @brief Title of the menu, nullptr if titleId is used
+   */
+  const char* title;
+
+  /**
+   * @brief The items of the menu
+   */
+  const StaticMenuEntry* entries;
+
+  /**
+   * @brief Number of items
+   */
+  uint8_t numberOfEntries;
+
+  /**
+   * @brief Number of the title in the string tables, used if title is nullptr
+   */
+  TextId titleId;
+};
+
+/**
+ * @brief Creates an item calling a function
+ */
+constexpr StaticMenuEntry menuAction(const char* text, void (*action)()) {
+  return {text, StaticMenuEntry::Type::action, 0, action, noText};
+}
+
+/**
+ * @brief Creates an item calling a function whose text is read from the
+ * current string table
+ */
+constexpr StaticMenuEntry menuAction(const TextId& text, void (*action)()) {
+  return {nullptr, StaticMenuEntry::Type::action, 0, action, text};
+}
+
+/**
+ * @brief Creates an item opening a submenu
+ *
+ * @param text text of the item
+ * @param menu index of the submenu in the menu table
+ */
+constexpr StaticMenuEntry menuLink(const char* text, const uint8_t& menu) {
+  return {text, StaticMenuEntry::Type::link, menu, nullptr, noText};
+}
+
+/**
+ * @brief Creates an item opening a submenu whose text is read from the
+ * current string table
+ *
+ * @param text number of the text in the string tables
+ * @param menu index of the submenu in the menu table
+ */
+constexpr StaticMenuEntry menuLink(const TextId& text, const uint8_t& menu) {
+  return {nullptr, StaticMenuEntry::Type::link, menu, nullptr, text};
+}
+
+/**
+ * @brief Creates an item returning to the parent menu
+ */
+constexpr StaticMenuEntry menuBack(const char* text) {
+  return {text, StaticMenuEntry::Type::back, 0, nullptr, noText};
+}
+
+/**
+ * @brief Creates an item returning to the parent menu whose text is read
+ * from the current string table
+ */
+constexpr StaticMenuEntry menuBack(const TextId& text) {
+  return {nullptr, StaticMenuEntry::Type::back, 0, nullptr, text};
+}
+
+/**
+ * @brief Creates a menu from an array of items
+ */
+template <size_t N>
+constexpr StaticMenu staticMenu(const char* title, const StaticMenuEntry (&entries)[N]) {
+  static_assert(N < 256, "A static menu can have at most 255 items");
+  return {title, entries, (uint8_t)N, noText};
+}
+
+/**
+ * @brief Creates a menu from an array of items whose title is read from the
+ * current string table
+ */
+template <size_t N>
+constexpr StaticMenu staticMenu(const TextId& title, const StaticMenuEntry (&entries)[N]) {
+  static_assert(N < 256, "A static menu can have at most 255 items");
+  return {nullptr, entries, (uint8_t)N, title};
+}
+
+/**
+ * @brief Length of a string at compile time, 0 for texts of the string
+ * tables
+ */
+constexpr size_t staticTextLength(const char* text) {
+  return text && *text ? 1 + staticTextLength(text + 1) : 0;
+}
+
+/**
+ * @brief Returns true if all links of the menu table point to a menu of the
+ * table and no menu is empty
+ */
+template <size_t N>
+constexpr bool staticMenuLinksValid(const StaticMenu (&menus)[N]) {
+  for (size_t menu = 0; menu < N; menu++) {
+    if (menus[menu].numberOfEntries == 0) {
+      return false;
+    }
+    for (size_t entry = 0; entry < menus[menu].numberOfEntries; entry++) {
+      if ((menus[menu].entries[entry].type == StaticMenuEntry::Type::link) &&
+          (menus[menu].entries[entry].target >= N)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Returns true if all titles and items fit into the display without
+ * animation. Items use two columns less than the display for the selection
+ * marker and the scrollbar. Texts of the string tables are checked by
+ * tools/string_compiler.py --columns.
+ */
+template <size_t N>
+constexpr bool staticMenuTextsFit(const StaticMenu (&menus)[N], const size_t& numberOfColumns) {
+  for (size_t menu = 0; menu < N; menu++) {
+    if (staticTextLength(menus[menu].title) > numberOfColumns) {
+      return false;
+    }
+    for (size_t entry = 0; entry < menus[menu].numberOfEntries; entry++) {
+      if (staticTextLength(menus[menu].entries[entry].text) + 2 > numberOfColumns) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Menu showing a tree of menus which is defined at compile time. The
+ * tables are read-only and nothing is allocated while the menu is built. Only
+ * the texts of the visible rows are copied to show them. Items and titles
+ * created with a TextId show the text of the current StringTable.
+ *
+ * Example:
+ * @code
+ * void start();
+ * constexpr lcd::StaticMenuEntry mainItems[] = {
+ *   lcd::menuAction("Start", &start),
+ *   lcd::menuLink("Settings", 1),
+ * };
+ * constexpr lcd::StaticMenuEntry settingsItems[] = {
+ *   lcd::menuAction("Reset", &reset),
+ *   lcd::menuBack("Back"),
+ * };
+ * constexpr lcd::StaticMenu menus[] = {
+ *   lcd::staticMenu("Main", mainItems),
+ *   lcd::staticMenu("Settings", settingsItems),
+ * };
+ * static_assert(lcd::staticMenuLinksValid(menus), "invalid link");
+ * static_assert(lcd::staticMenuTextsFit(menus, 20), "text too long");
+ *
+ * lcd::StaticMenuView menu(&display, "menu", &encoder, menus, 20, 4);
+ * @endcode
+ */
+class StaticMenuView : public MenuView {
+protected:
+  /**
+   * @brief The menu table, the first menu is the root
+   */
+  const StaticMenu* menus;
+
+protected:
+  /**
+   * @brief Index of the shown menu
+   */
+  uint8_t currentMenu;
+
+protected:
+  /**
+   * @brief Number of parent menus stored in the stacks
+   */
+  uint8_t depth;
+
+protected:
+  /**
+   * @brief Parents of the shown menu
+   */
+  uint8_t menuStack[LCD_STATIC_MENU_DEPTH];
+
+protected:
+  /**
+   * @brief Selection of the parents of the shown menu
+   */
+  int selectionStack[LCD_STATIC_MENU_DEPTH];
+
+protected:
+  /**
+   * @brief Entries of the visible rows
+   */
+  RowCache rowCache;
+
+public:
+  /**
+   * @brief Construct a view object
+   *
+   * @param display pointer to the display instance
+   * @param name The name of the view
+   * @param encoder pointer to the encoder instance
+   * @param menus the menu table, the first menu is the root
+   * @param numberOfColumns number of display-columns
+   * @param numberOfRows number of display-rows
+   */
+  template <size_t N>
+  StaticMenuView(LiquidCrystal_PCF8574* display,
+                 const String& name,
+                 RotaryEncoder* encoder,
+                 const StaticMenu (&menus)[N],
+                 const int& numberOfColumns,
+                 const int& numberOfRows)
+    // titles of the string tables are loaded by the first tick, a
+    // placeholder reserves their row
+    : MenuView(display, name, encoder, menus[0].title ? menus[0].title : " ", numberOfColumns, numberOfRows)
+    , menus(menus)
+    , currentMenu(0)
+    , depth(0) {}
+
+public:
+  /**
+   * @brief Shows the root menu during the next activation
+   */
+  void reset() {
+    depth = 0;
+    currentMenu = 0;
+    title.setText(getMenuTitle(0));
+    rowCache.invalidate();
+    jumpIndex.invalidate();
+  }
+
+protected:
+  /**
+   * @brief called as soon as the view becomes active
+   */
+  virtual void activate() {
+    rowCache.invalidate();
+    MenuView::activate();
+  }
+
+protected:
+  /**
+   * @brief Shows another menu of the table
+   *
+   * @param menu index of the menu
+   * @param newSelection the selected item
+   */
+  void showMenu(const uint8_t& menu, const int& newSelection) {
+    currentMenu = menu;
+    title.setText(getMenuTitle(menu));
+    rowCache.invalidate();
+    jumpIndex.invalidate();
+    selection = newSelection;
+    firstVisibleItem = 0;
+    updateFirstVisibleItem();
+    redraw();
+  }
+
+protected:
+  virtual int getNumberOfItems() {
+    return menus[currentMenu].numberOfEntries;
+  }
+
+protected:
+  virtual LongEntry& getEntry(const int& index) {
+    LongEntry* entry = rowCache.find(index, numberOfRowsUsedForItems);
+    if (!entry) {
+      entry = &rowCache.assign(index, numberOfRowsUsedForItems, getItemText(index));
+    }
+    return *entry;
+  }
+
+protected:
+  virtual String getItemText(const int& index) {
+    const StaticMenuEntry& entry = menus[currentMenu].entries[index];
+    return entry.text ? String(entry.text) : StringTable::translate(entry.textId);
+  }
+
+protected:
+  /**
+   * @brief Returns the title of a menu of the table
+   */
+  String getMenuTitle(const uint8_t& menu) {
+    return menus[menu].title ? String(menus[menu].title) : StringTable::translate(menus[menu].titleId);
+  }
+
+protected:
+  /**
+   * @brief Loads the title and the shown items again after the current
+   * string table changed
+   */
+  virtual void textsChanged() {
+    title.setText(getMenuTitle(currentMenu));
+    rowCache.invalidate();
+    jumpIndex.invalidate();
+  }
+
+protected:
+  virtual bool isItemEnabled(const int& index) {
+    return true;
+  }
+
+protected:
+  virtual void selectItem(const int& index) {
+    const StaticMenuEntry& entry = menus[currentMenu].entries[index];
+    switch (entry.type) {
+    case StaticMenuEntry::Type::action:
+      if (entry.action) {
+        entry.action();
+      }
+      break;
+    case StaticMenuEntry::Type::link:
+      // if the stack is full the deepest parent is not stored
+      if (depth < LCD_STATIC_MENU_DEPTH) {
+        menuStack[depth] = currentMenu;
+        selectionStack[depth] = selection;
+        depth++;
+      }
+      showMenu(entry.target, 0);
+      break;
+    case StaticMenuEntry::Type::back:
+      goBack();
+      break;
+    }
+  }
+
+protected:
+  /**
+   * @brief Returns to the parent menu or to the previous view if the root
+   * menu is shown
+   */
+  virtual bool goBack() {
+    if (depth == 0) {
+      return MenuView::goBack();
+    }
+    depth--;
+    showMenu(menuStack[depth], selectionStack[depth]);
+    return true;
+  }
+};
+
+LCD_ASSERT_SIZE(StaticMenuView, LCD_BUDGET_STATIC_MENU_VIEW);
+} // namespace lcd
@@ -0,0 +1,93 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Overlay.h"
+#include "ViewBase.h"
+
+#include <Arduino.h>
+#include <functional>
+
+namespace lcd {
+/**
+ * @brief Overlay which calls a function to update its content
+ */
+class CallbackOverlay : public Overlay {
+protected:
+  /**
+   * @brief Function updating the content of the overlay
+   */
+  const std::function<void(Overlay*)> callback;
+
+public:
+  /**
+   * @brief Construct a new overlay
+   *
+   * @param column first display-column covered by the overlay
+   * @param row display-row covered by the overlay
+   * @param width number of display-columns covered by the overlay
+   * @param interval interval in milliseconds in which the callback is called
+   * @param callback function updating the content, e.g. a clock
+   */
+  CallbackOverlay(const uint8_t& column,
+                  const uint8_t& row,
+                  const uint8_t& width,
+                  const unsigned long& interval,
+                  const std::function<void(Overlay*)>& callback)
+    : Overlay(column, row, width, interval)
+    , callback(callback) {}
+
+protected:
+  /**
+   * @brief Calls the callback
+   */
+  virtual void update() {
+    callback(this);
+  }
+};
+
+/**
+ * @brief Overlay showing the WIFI signal strength using the special
+ * characters of ViewBase in a single cell
+ */
+class WifiSignalOverlay : public Overlay {
+protected:
+  /**
+   * @brief Function returning the signal strength from 0 (lowest) to 3 (best)
+   * or a negative value if there is no connection
+   */
+  const std::function<int()> getSignalStrength;
+
+public:
+  /**
+   * @brief Construct a new overlay
+   *
+   * @param column display-column of the symbol
+   * @param row display-row of the symbol
+   * @param interval interval in milliseconds in which the strength is updated
+   * @param getSignalStrength function returning the signal strength from 0
+   * (lowest) to 3 (best) or a negative value if there is no connection
+   */
+  WifiSignalOverlay(const uint8_t& column,
+                    const uint8_t& row,
+                    const unsigned long& interval,
+                    const std::function<int()>& getSignalStrength)
+    : Overlay(column, row, 1, interval)
+    , getSignalStrength(getSignalStrength) {}
+
+protected:
+  /**
+   * @brief Updates the symbol
+   */
+  virtual void update() {
+    const int strength = getSignalStrength();
+#if LCD_FEATURE_GLYPHS
+    setCell(0, strength < 0 ? ' ' : ViewBase::scWifiSignal0 + (strength > 3 ? 3 : strength));
+#else
+    setCell(0, strength < 0 ? ' ' : '0' + (strength > 3 ? 3 : strength));
+#endif
+  }
+};
+} // namespace lcd
@@ -0,0 +1,431 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Clock.h"
+#include "DisplaySink.h"
+#include "MenuView.h"
+#include "TableView.h"
+#include "ValueEditView.h"
+#include "ViewBase.h"
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace lcd {
+/**
+ * @brief Drives random input events and random time steps through views and
+ * checks after every tick that
+ * - the selection of menus, the scroll position of tables and the value of
+ *   value editors are in range,
+ * - no view writes outside the display and the frame only sends cells
+ *   inside the display,
+ * - the content the frame assumes on the LCD matches what it sent,
+ * - a tick does not take longer than a limit.
+ *
+ * The harness is the sink of the frame and a SimulatedClock is installed
+ * while it runs. The clock starts shortly before the wraparound of millis.
+ * Runs with the same seed produce the same events, so a violation can be
+ * reproduced using the seed and the tick of the report.
+ * test/host/stress_harness.cpp runs it on the views of the library and on
+ * several display geometries.
+ *
+ * Example (on the host):
+ * @code
+ * lcd::StressHarness harness(seed);
+ * harness.addView(menu);
+ * harness.addView(table);
+ * harness.setOnTick([&](const uint32_t& random) {
+ *   // e.g. hide a random item
+ * });
+ * lcd::StressHarness::Report report = harness.run(menu, 1000000);
+ * printf("%lu violations, %.0f ticks/s\n", report.violations, report.ticksPerSecond);
+ * @endcode
+ */
+class StressHarness : public DisplaySink {
+public:
+  /**
+   * @brief Result of a run
+   */
+  struct Report {
+    /**
+     * @brief Number of ticks
+     */
+    unsigned long ticks;
+
+    /**
+     * @brief Number of ticks which violated an invariant
+     */
+    unsigned long violations;
+
+    /**
+     * @brief Tick of the first violation
+     */
+    unsigned long firstViolationTick;
+
+    /**
+     * @brief Description of the first violation, empty if there was none
+     */
+    String firstViolation;
+
+    /**
+     * @brief Longest tick in microseconds
+     */
+    uint32_t longestTick;
+
+    /**
+     * @brief Number of ticks per second of wall time
+     */
+    double ticksPerSecond;
+  };
+
+protected:
+  /**
+   * @brief Invariant of one view, returns nullptr if it holds
+   */
+  struct Check {
+    /**
+     * @brief The checked view
+     */
+    ViewBase* view;
+
+    /**
+     * @brief The invariant
+     */
+    std::function<const char*()> check;
+  };
+
+protected:
+  /**
+   * @brief Invariants of the registered views
+   */
+  std::vector<Check> checks;
+
+protected:
+  /**
+   * @brief State of the random number generator
+   */
+  uint32_t randomState;
+
+protected:
+  /**
+   * @brief Maximum duration of a tick in microseconds
+   */
+  uint32_t tickLimit;
+
+protected:
+  /**
+   * @brief Percentage of writes refused by canAccept
+   */
+  uint8_t refusalRate;
+
+protected:
+  /**
+   * @brief Called with a random number before every tick
+   */
+  std::function<void(const uint32_t&)> onTick;
+
+protected:
+  /**
+   * @brief Content of the simulated LCD
+   */
+  uint8_t screen[LCD_FRAME_ROWS][LCD_FRAME_COLUMNS];
+
+protected:
+  /**
+   * @brief True as soon as the frame cleared the simulated LCD. Before that
+   * the frame does not know the content of the LCD.
+   */
+  bool cleared;
+
+protected:
+  /**
+   * @brief Violation detected by the sink during the current tick
+   */
+  const char* sinkViolation;
+
+public:
+  /**
+   * @brief Construct a new harness
+   *
+   * @param seed seed of the random events, must not be 0
+   * @param tickLimit maximum duration of a tick in microseconds
+   */
+  StressHarness(const uint32_t& seed, const uint32_t& tickLimit = 10000)
+    : randomState(seed ? seed : 1)
+    , tickLimit(tickLimit)
+    , refusalRate(0)
+    , cleared(false)
+    , sinkViolation(nullptr) {
+    clear();
+  }
+
+public:
+  /**
+   * @brief Registers a menu, its selection is checked while it is shown
+   */
+  void addView(MenuView& view) {
+    MenuView* menu = &view;
+    checks.push_back({menu, [menu]() -> const char* {
+                        const int numberOfItems = menu->getNumberOfItems();
+                        if ((numberOfItems == 0) && (menu->selection != 0)) {
+                          return "MenuView: selection of an empty menu is not 0";
+                        }
+                        if ((numberOfItems > 0) && ((menu->selection < 0) || (menu->selection >= numberOfItems))) {
+                          return "MenuView: selection out of range";
+                        }
+                        if ((menu->selection < menu->firstVisibleItem) ||
+                            (menu->selection >= menu->firstVisibleItem + menu->numberOfRowsUsedForItems)) {
+                          return "MenuView: selection not visible";
+                        }
+                        return nullptr;
+                      }});
+  }
+
+public:
+  /**
+   * @brief Registers a table, its scroll position is checked while it is
+   * shown
+   */
+  void addView(TableView& view) {
+    TableView* table = &view;
+    checks.push_back({table, [table]() -> const char* {
+                        const int last = std::max(table->numberOfDataRows - table->numberOfRowsUsedForData, 0);
+                        if ((table->firstVisibleRow < 0) || (table->firstVisibleRow > last)) {
+                          return "TableView: scroll position out of range";
+                        }
+                        return nullptr;
+                      }});
+  }
+
+public:
+  /**
+   * @brief Registers a value editor, its value is checked while it is shown
+   */
+  template <typename T>
+  void addView(ValueEditView<T>& view) {
+    ValueEditView<T>* editor = &view;
+    checks.push_back({editor, [editor]() -> const char* {
+                        if ((editor->value < editor->minimum) || (editor->value > editor->maximum)) {
+                          return "ValueEditView: value out of range";
+                        }
+                        return nullptr;
+                      }});
+  }
+
+public:
+  /**
+   * @brief Registers a view without own invariants
+   */
+  void addView(ViewBase& view) {
+    checks.push_back({&view, []() -> const char* { return nullptr; }});
+  }
+
+public:
+  /**
+   * @brief Sets a function called with a random number before every tick,
+   * e.g. to change items or values while the view is shown
+   */
+  void setOnTick(std::function<void(const uint32_t&)> callback) {
+    onTick = std::move(callback);
+  }
+
+public:
+  /**
+   * @brief Lets canAccept refuse a percentage of the writes, so the frame
+   * has to keep changes pending
+   */
+  void setRefusalRate(const uint8_t& percent) {
+    refusalRate = percent;
+  }
+
+public:
+  /**
+   * @brief Returns the next random number (xorshift32)
+   */
+  uint32_t random() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+  }
+
+public:
+  /**
+   * @brief Activates a view and ticks the shown view with random events and
+   * time steps. Views can be left and entered by the events, every
+   * registered view is checked while it is shown.
+   *
+   * @param view the first shown view
+   * @param ticks number of ticks
+   */
+  Report run(ViewBase& view, const unsigned long& ticks) {
+    Report report = {0, 0, 0, String(), 0, 0};
+    Frame& frame = ViewBase::getFrame();
+    DisplaySink* previousSink = frame.getSink();
+    Clock* previousClock = &Clock::get();
+    SimulatedClock clock(0xFFFFFFFF - 60000);
+    Clock::set(&clock);
+    // the frame clears the LCD during the first flush
+    cleared = false;
+    frame.setSink(this);
+    frame.invalidate();
+
+    const auto start = std::chrono::steady_clock::now();
+    // without a previous view the views of earlier runs can be destroyed
+    ViewBase::activateView(nullptr);
+    ViewBase::activateView(&view);
+    for (report.ticks = 0; report.ticks < ticks; report.ticks++) {
+      if (onTick) {
+        onTick(random());
+      }
+      clock.advance(randomTimeStep());
+      ViewBase::getInput().inject(randomEvent());
+
+      sinkViolation = nullptr;
+      const uint16_t droppedCharacters = frame.getDroppedCharacters();
+      ViewBase* current = ViewBase::getCurrentView();
+      const auto tickStart = std::chrono::steady_clock::now();
+      current->tick(false);
+      const uint32_t duration = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - tickStart)
+                                  .count();
+      report.longestTick = std::max(report.longestTick, duration);
+
+      // check the view which is shown after the tick
+      const char* violation = sinkViolation;
+      if (!violation && (frame.getDroppedCharacters() != droppedCharacters)) {
+        violation = "a view wrote outside the display";
+      }
+      if (!violation && cleared && !shownMatches(frame)) {
+        violation = "the frame's copy of the LCD differs from the written cells";
+      }
+      if (!violation && (duration > tickLimit)) {
+        violation = "tick exceeded the time limit";
+      }
+      for (auto& check : checks) {
+        if (!violation && (check.view == ViewBase::getCurrentView())) {
+          violation = check.check();
+        }
+      }
+      if (violation) {
+        if (report.violations == 0) {
+          report.firstViolation = violation;
+          report.firstViolationTick = report.ticks;
+        }
+        report.violations++;
+      }
+    }
+    const double seconds =
+      std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count();
+    report.ticksPerSecond = seconds > 0 ? report.ticks / seconds : 0;
+
+    frame.setSink(previousSink);
+    Clock::set(previousClock);
+    return report;
+  }
+
+public:
+  virtual bool canAccept(const size_t& operations) {
+    return (refusalRate == 0) || (random() % 100 >= refusalRate);
+  }
+
+public:
+  virtual void clear() {
+    for (auto& row : screen) {
+      std::fill_n(row, LCD_FRAME_COLUMNS, ' ');
+    }
+    cleared = true;
+  }
+
+public:
+  virtual void writeCells(const uint8_t& column, const uint8_t& row, const uint8_t* data, const uint8_t& length) {
+    const Frame& frame = ViewBase::getFrame();
+    if ((row >= frame.getNumberOfRows()) || (column + length > frame.getNumberOfColumns())) {
+      sinkViolation = "the frame sent cells outside the display";
+      return;
+    }
+    std::copy(data, data + length, screen[row] + column);
+  }
+
+public:
+  virtual void createChar(const uint8_t& location, const uint8_t* charmap) {
+    if (location >= 8) {
+      sinkViolation = "the frame uploaded an invalid special character";
+    }
+  }
+
+public:
+  virtual void setBacklight(const bool& on) {}
+
+protected:
+  /**
+   * @brief Returns true if the content the frame assumes on the LCD matches
+   * the written cells
+   */
+  bool shownMatches(const Frame& frame) const {
+    for (uint8_t row = 0; row < frame.getNumberOfRows(); row++) {
+      for (uint8_t column = 0; column < frame.getNumberOfColumns(); column++) {
+        if (frame.getShownCell(column, row) != screen[row][column]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+protected:
+  /**
+   * @brief Returns a random event, mostly rotations
+   */
+  InputEvent randomEvent() {
+    const uint32_t value = random() % 100;
+    if (value < 20) {
+      return InputEvent::none;
+    }
+    else if (value < 42) {
+      return InputEvent::up;
+    }
+    else if (value < 64) {
+      return InputEvent::down;
+    }
+    else if (value < 72) {
+      return InputEvent::pressTurnUp;
+    }
+    else if (value < 80) {
+      return InputEvent::pressTurnDown;
+    }
+    else if (value < 90) {
+      return InputEvent::select;
+    }
+    else if (value < 94) {
+      return InputEvent::back;
+    }
+    else if (value < 97) {
+      return InputEvent::longPress;
+    }
+    return InputEvent::doubleClick;
+  }
+
+protected:
+  /**
+   * @brief Returns a random time step in milliseconds, mostly short steps
+   * and sometimes several minutes
+   */
+  uint32_t randomTimeStep() {
+    const uint32_t value = random() % 100;
+    if (value < 70) {
+      return random() % 50;
+    }
+    else if (value < 95) {
+      return 50 + random() % 2000;
+    }
+    return random() % 600000;
+  }
+};
+} // namespace lcd
@@ -0,0 +1,217 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Log.h"
+#include "MenuSource.h"
+
+#include <Arduino.h>
+
+/**
+ * Maximum length of a text read from a string table. Longer texts are cut.
+ */
+#ifndef LCD_STRING_TABLE_MAX_TEXT
+#define LCD_STRING_TABLE_MAX_TEXT 64
+#endif
+
+namespace lcd {
+/**
+ * @brief Number of a text in the string tables, e.g. generated by
+ * tools/string_compiler.py
+ */
+typedef uint16_t TextId;
+
+/**
+ * @brief TextId of items and dialogs whose text is not read from a string
+ * table
+ */
+constexpr TextId noText = 0xFFFF;
+
+/**
+ * @brief Texts of one language read from a binary string table. The table is
+ * not copied into RAM, every text is read when it is shown. Menu items and
+ * dialogs created with a TextId show the text of the current table, so
+ * switching the language only changes the current table.
+ *
+ * File format (all numbers little endian):
+ * - header: "LCDS", version (1 byte), reserved (1 byte), number of texts
+ *   (2 bytes), followed by the offset of each text (4 bytes each)
+ * - text: length (1 byte) followed by the characters
+ *
+ * Example:
+ * @code
+ * #include "texts/en.h" // string_compiler.py texts.json texts --progmem
+ * #include "texts/de.h"
+ * lcd::MemoryMenuSource englishSource(texts_en, sizeof(texts_en));
+ * lcd::MemoryMenuSource germanSource(texts_de, sizeof(texts_de));
+ * lcd::StringTable english(&englishSource);
+ * lcd::StringTable german(&germanSource);
+ *
+ * void setup() {
+ *   ...
+ *   english.begin();
+ *   german.begin();
+ *   lcd::StringTable::setCurrent(&english);
+ *   menu.createMenuItem(TextKey::start, ...);
+ * }
+ *
+ * void switchToGerman() {
+ *   lcd::StringTable::setCurrent(&german);
+ * }
+ * @endcode
+ */
+class StringTable {
+public:
+  /**
+   * @brief Version of the file format
+   */
+  const static uint8_t formatVersion = 1;
+
+protected:
+  /**
+   * @brief The string table file
+   */
+  MenuSource* source;
+
+protected:
+  /**
+   * @brief Number of texts in the file, 0 if the file is invalid
+   */
+  uint16_t numberOfTexts;
+
+public:
+  /**
+   * @brief Construct a table. The file is read by begin.
+   *
+   * @param source the string table file
+   */
+  StringTable(MenuSource* source)
+    : source(source)
+    , numberOfTexts(0) {}
+
+public:
+  /**
+   * @brief Reads the header of the file
+   *
+   * @return false if the file is invalid
+   */
+  bool begin() {
+    uint8_t header[8];
+    numberOfTexts = 0;
+    if (!source->read(0, header, sizeof(header)) || (memcmp(header, "LCDS", 4) != 0) ||
+        (header[4] != formatVersion)) {
+      LCD_LOG_ERROR("Invalid string table");
+      return false;
+    }
+    numberOfTexts = header[6] | (header[7] << 8);
+    return true;
+  }
+
+public:
+  /**
+   * @brief Returns the number of texts, 0 if the file is invalid
+   */
+  uint16_t size() const {
+    return numberOfTexts;
+  }
+
+public:
+  /**
+   * @brief Reads a text of the table
+   *
+   * @param id number of the text
+   * @return the text or '?' followed by the number if the text is missing
+   */
+  String getText(const TextId& id) {
+    uint8_t buffer[4];
+    uint8_t length = 0;
+    char text[LCD_STRING_TABLE_MAX_TEXT + 1];
+    if ((id >= numberOfTexts) || !source->read(8 + 4 * (uint32_t)id, buffer, 4)) {
+      return missingText(id);
+    }
+    const uint32_t offset =
+      (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+    if (!source->read(offset, &length, 1)) {
+      return missingText(id);
+    }
+    length = length < LCD_STRING_TABLE_MAX_TEXT ? length : LCD_STRING_TABLE_MAX_TEXT;
+    if (!source->read(offset + 1, (uint8_t*)text, length)) {
+      return missingText(id);
+    }
+    text[length] = 0;
+    return String(text);
+  }
+
+public:
+  /**
+   * @brief Sets the table used by menu items and dialogs created with a
+   * TextId. The shown view loads its texts again during its next tick, other
+   * views as soon as they are activated.
+   *
+   * @param table the new table or nullptr if no texts are available
+   */
+  static void setCurrent(StringTable* table) {
+    getCurrentInstance() = table;
+    // 0 is reserved for texts which were never loaded
+    uint16_t& revision = getRevisionInstance();
+    revision = revision == 0xFFFF ? 1 : revision + 1;
+  }
+
+public:
+  /**
+   * @brief Returns the current table or nullptr if no table is set
+   */
+  static StringTable* getCurrent() {
+    return getCurrentInstance();
+  }
+
+public:
+  /**
+   * @brief Returns a number which changes every time the current table is
+   * set. Views compare it with the number of their loaded texts.
+   */
+  static uint16_t getRevision() {
+    return getRevisionInstance();
+  }
+
+public:
+  /**
+   * @brief Returns a text of the current table
+   *
+   * @param id number of the text
+   * @return the text or '?' followed by the number if the text is missing
+   */
+  static String translate(const TextId& id) {
+    StringTable* table = getCurrentInstance();
+    return table ? table->getText(id) : missingText(id);
+  }
+
+protected:
+  /**
+   * @brief Returns the text shown instead of a missing text
+   */
+  static String missingText(const TextId& id) {
+    return "?" + String(id);
+  }
+
+protected:
+  /**
+   * @brief Returns the pointer to the current table
+   */
+  static StringTable*& getCurrentInstance() {
+    static StringTable* table = nullptr;
+    return table;
+  }
+
+protected:
+  /**
+   * @brief Returns the revision of the current table
+   */
+  static uint16_t& getRevisionInstance() {
+    static uint16_t revision = 1;
+    return revision;
+  }
+};
+} // namespace lcd
@@ -0,0 +1,577 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "ViewBase.h"
+
+#include <Arduino.h>
+#include <RotaryEncoder.h>
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+/**
+ * Maximum number of columns of a TableView
+ */
+#ifndef LCD_TABLE_MAX_COLUMNS
+#define LCD_TABLE_MAX_COLUMNS 4
+#endif
+
+namespace lcd {
+/**
+ * @brief Provides the rows shown by a TableView. The cells are only read for
+ * the visible rows, so the data can be stored anywhere, e.g. in a sensor
+ * driver.
+ */
+class TableSource {
+public:
+  /**
+   * @brief Destroy the source
+   */
+  virtual ~TableSource() {}
+
+public:
+  /**
+   * @brief Returns the number of rows
+   */
+  virtual int getNumberOfRows() = 0;
+
+public:
+  /**
+   * @brief Returns the text of a cell
+   *
+   * @param row index of the row
+   * @param column index of the column
+   */
+  virtual String getCell(const int& row, const uint8_t& column) = 0;
+
+public:
+  /**
+   * @brief Compares two rows by a column. Compares the texts of the cells by
+   * default, should be overridden for numeric columns.
+   *
+   * @return a negative value if the first row is smaller, 0 if the rows are
+   * equal and a positive value if the first row is larger
+   */
+  virtual int compare(const int& rowA, const int& rowB, const uint8_t& column) {
+    return strcmp(getCell(rowA, column).c_str(), getCell(rowB, column).c_str());
+  }
+};
+
+/**
+ * @brief View showing rows of a TableSource in columns of fixed width, e.g.
+ * sensor, value and status. Only the rows of the visible window are cached.
+ * Changed cells reported by updateCell are read again and redrawn without
+ * touching the rest of the table.
+ *
+ * Rotating the encoder scrolls the table, a click sorts the table by the next
+ * column (and finally unsorts it) and back activates the previous view. Since
+ * only a screenful is visible the rows are sorted partially: only the rows up
+ * to the end of the visible window are put in order, further rows are sorted
+ * when the table is scrolled.
+ *
+ * Example:
+ * @code
+ * lcd::TableView table(&display, "sensors", &encoder, &source, 20, 4);
+ * table.addColumn("Sensor", 10);
+ * table.addColumn("Value", 6, lcd::TableView::Alignment::right);
+ * table.addColumn(" St", 4);
+ * ...
+ * source.setValue(3, 21.5);
+ * table.updateCell(3, 1);
+ * @endcode
+ */
+class TableView : public ViewBase {
+  friend class StressHarness;
+
+  static_assert(LCD_TABLE_MAX_COLUMNS <= 8, "A TableView can have at most 8 columns");
+
+public:
+  /**
+   * @brief Alignment of the texts in a column
+   */
+  enum class Alignment { left, right };
+
+protected:
+  /**
+   * @brief Definition of a column
+   */
+  struct Column {
+    /**
+     * @brief Text shown in the header row
+     */
+    String header;
+
+    /**
+     * @brief Number of display-columns used by the column
+     */
+    uint8_t width;
+
+    /**
+     * @brief Alignment of the texts
+     */
+    Alignment alignment;
+  };
+
+protected:
+  /**
+   * @brief pointer to the encoder instance
+   */
+  RotaryEncoder* encoder;
+
+protected:
+  /**
+   * @brief The shown data
+   */
+  TableSource* source;
+
+protected:
+  /**
+   * @brief The columns of the table
+   */
+  Column columns[LCD_TABLE_MAX_COLUMNS];
+
+protected:
+  /**
+   * @brief Number of used columns
+   */
+  uint8_t numberOfTableColumns;
+
+protected:
+  /**
+   * @brief If true the first display-row shows the headers of the columns
+   */
+  const bool showHeader;
+
+protected:
+  /**
+   * @brief Number of rows of the source when it was read the last time
+   */
+  int numberOfDataRows;
+
+protected:
+  /**
+   * @brief Position of the row shown in the first display-row used for rows
+   */
+  int firstVisibleRow;
+
+protected:
+  /**
+   * @brief Column by which the rows are sorted, -1 if unsorted
+   */
+  int sortColumn;
+
+protected:
+  /**
+   * @brief If true the rows are sorted ascending
+   */
+  bool sortAscending;
+
+protected:
+  /**
+   * @brief Rows of the source in sorted order, empty if unsorted. Stored as
+   * int like the row numbers of the TableSource, on AVR int has 16 bits.
+   */
+  std::vector<int> order;
+
+protected:
+  /**
+   * @brief Number of rows at the beginning of order which are sorted
+   */
+  int sortedCount;
+
+protected:
+  /**
+   * @brief Position of the row cached in each slot, -1 if empty. The row at
+   * a position is cached in slot position % numberOfRowsUsedForData.
+   */
+  int cachedPositions[LCD_FRAME_ROWS];
+
+protected:
+  /**
+   * @brief Row of the source cached in each slot
+   */
+  int cachedRows[LCD_FRAME_ROWS];
+
+protected:
+  /**
+   * @brief Texts of the cached cells
+   */
+  String cells[LCD_FRAME_ROWS][LCD_TABLE_MAX_COLUMNS];
+
+protected:
+  /**
+   * @brief Bitmask of the cells of each slot which must be read again
+   */
+  uint8_t dirtyCells[LCD_FRAME_ROWS];
+
+protected:
+  /**
+   * @brief If true the header row must be redrawn
+   */
+  bool headerModified;
+
+protected:
+  /**
+   * @brief If true all rows must be redrawn, e.g. after sorting
+   */
+  bool rowsModified;
+
+public:
+  /**
+   * @brief Number of display-columns
+   */
+  const int numberOfColumns;
+
+public:
+  /**
+   * @brief Number of display-rows
+   */
+  const int numberOfRows;
+
+public:
+  /**
+   * @brief Number of display-rows used for rows of the table
+   */
+  const int numberOfRowsUsedForData;
+
+public:
+  /**
+   * @brief Construct a new view
+   *
+   * @param display pointer to the display instance
+   * @param name The name of the view
+   * @param encoder pointer to the encoder instance
+   * @param source the shown data
+   * @param numberOfColumns number of display-columns
+   * @param numberOfRows number of display-rows
+   * @param showHeader if true the first row shows the headers of the columns
+   */
+  TableView(LiquidCrystal_PCF8574* display,
+            const String& name,
+            RotaryEncoder* encoder,
+            TableSource* source,
+            const int& numberOfColumns,
+            const int& numberOfRows,
+            const bool& showHeader = true)
+    : ViewBase(display, name)
+    , encoder(encoder)
+    , source(source)
+    , numberOfTableColumns(0)
+    , showHeader(showHeader && (numberOfRows > 1))
+    , numberOfDataRows(0)
+    , firstVisibleRow(0)
+    , sortColumn(-1)
+    , sortAscending(true)
+    , sortedCount(0)
+    , headerModified(true)
+    , rowsModified(true)
+    , numberOfColumns(numberOfColumns)
+    , numberOfRows(numberOfRows)
+    , numberOfRowsUsedForData(this->showHeader ? numberOfRows - 1 : numberOfRows) {
+    invalidateCache();
+    ViewBase::display->setSize(numberOfColumns, numberOfRows);
+    getInput().useEncoder(encoder);
+  }
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  TableView(const TableView& other) = delete;
+
+public:
+  /**
+   * @brief Adds a column. The columns are shown from left to right in the
+   * order they were added.
+   *
+   * @param header text shown in the header row
+   * @param width number of display-columns used by the column
+   * @param alignment alignment of the texts
+   * @return false if the maximum number of columns is reached
+   */
+  bool addColumn(const String& header, const uint8_t& width, const Alignment& alignment = Alignment::left) {
+    if (numberOfTableColumns >= LCD_TABLE_MAX_COLUMNS) {
+      return false;
+    }
+    columns[numberOfTableColumns++] = {header, width, alignment};
+    headerModified = true;
+    invalidateCache();
+    return true;
+  }
+
+public:
+  /**
+   * @brief Must be called if a cell changed. If the cell is visible only the
+   * cell is redrawn during the next tick. If the table is sorted by the
+   * column the rows are sorted again.
+   *
+   * @param row index of the row in the source
+   * @param column index of the column
+   */
+  void updateCell(const int& row, const uint8_t& column) {
+    if (column == sortColumn) {
+      resort();
+      return;
+    }
+    for (int slot = 0; slot < numberOfRowsUsedForData; slot++) {
+      if ((cachedPositions[slot] >= 0) && (cachedRows[slot] == row)) {
+        dirtyCells[slot] |= 1 << column;
+      }
+    }
+  }
+
+public:
+  /**
+   * @brief Must be called if all cells of a row changed
+   *
+   * @param row index of the row in the source
+   */
+  void updateRow(const int& row) {
+    if (sortColumn >= 0) {
+      resort();
+      return;
+    }
+    for (int slot = 0; slot < numberOfRowsUsedForData; slot++) {
+      if ((cachedPositions[slot] >= 0) && (cachedRows[slot] == row)) {
+        dirtyCells[slot] = 0xFF;
+      }
+    }
+  }
+
+public:
+  /**
+   * @brief Must be called if rows were added or removed. All visible cells
+   * are read again.
+   */
+  void invalidate() {
+    resort();
+  }
+
+public:
+  /**
+   * @brief Sorts the rows by a column
+   *
+   * @param column index of the column, -1 to show the rows unsorted
+   * @param ascending if true the smallest row is shown first
+   */
+  void sortBy(const int& column, const bool& ascending = true) {
+    sortColumn = column < numberOfTableColumns ? column : -1;
+    sortAscending = ascending;
+    headerModified = true;
+    resort();
+  }
+
+protected:
+  /**
+   * @brief called as soon as the view becomes active
+   */
+  virtual void activate() {
+    display->clear();
+    invalidateCache();
+    headerModified = true;
+    tick(true);
+  }
+
+public:
+  /**
+   * @brief called during the loop function
+   *
+   * @param forceRedraw if true everything should be redrawn
+   */
+  virtual void tick(const bool& forceRedraw) {
+    const InputEvent event = readInput();
+
+    // Update the backlight timeout
+    if (event != InputEvent::none) {
+      if (!getBacklightTimeoutManager().delayTimeout()) {
+        getBacklightTimeoutManager().tick(display);
+        display->present();
+        return;
+      }
+    }
+    getBacklightTimeoutManager().tick(display);
+
+    if (event == InputEvent::back) {
+      activatePreviousView();
+      return;
+    }
+    else if (event == InputEvent::select) {
+      // sort by the next column, after the last column the table is unsorted
+      sortBy(sortColumn + 1 < numberOfTableColumns ? sortColumn + 1 : -1);
+    }
+
+    if (numberOfDataRows != source->getNumberOfRows()) {
+      resort();
+    }
+
+    // scroll
+    const int previousFirstVisibleRow = firstVisibleRow;
+    const int lastFirstRow = std::max(numberOfDataRows - numberOfRowsUsedForData, 0);
+    if (event == InputEvent::down) {
+      firstVisibleRow = std::min(firstVisibleRow + 1, lastFirstRow);
+    }
+    else if (event == InputEvent::up) {
+      firstVisibleRow = std::max(firstVisibleRow - 1, 0);
+    }
+    firstVisibleRow = std::min(firstVisibleRow, lastFirstRow);
+    const bool fullRedraw = forceRedraw || rowsModified || (firstVisibleRow != previousFirstVisibleRow);
+    rowsModified = false;
+
+    if (showHeader && (headerModified || forceRedraw)) {
+      drawHeader();
+    }
+
+    for (int i = 0; i < numberOfRowsUsedForData; i++) {
+      const int position = firstVisibleRow + i;
+      const int displayRow = i + numberOfRows - numberOfRowsUsedForData;
+      if (position >= numberOfDataRows) {
+        if (fullRedraw) {
+          display->setCursor(0, displayRow);
+          for (int j = 0; j < numberOfColumns; j++) {
+            display->write(' ');
+          }
+        }
+        continue;
+      }
+
+      // rows which stay visible while scrolling keep their cached cells
+      const int slot = position % numberOfRowsUsedForData;
+      if (cachedPositions[slot] != position) {
+        cachedPositions[slot] = position;
+        cachedRows[slot] = getRowAt(position);
+        dirtyCells[slot] = 0xFF;
+      }
+
+      int x = 0;
+      for (uint8_t column = 0; column < numberOfTableColumns; column++) {
+        const bool dirty = dirtyCells[slot] & (1 << column);
+        if (dirty) {
+          cells[slot][column] = source->getCell(cachedRows[slot], column);
+        }
+        if (dirty || fullRedraw) {
+          drawCell(x, displayRow, columns[column], cells[slot][column]);
+        }
+        x += columns[column].width;
+      }
+      if (fullRedraw && (x < numberOfColumns)) {
+        display->setCursor(x, displayRow);
+        for (; x < numberOfColumns; x++) {
+          display->write(' ');
+        }
+      }
+      dirtyCells[slot] = 0;
+    }
+
+    // send the changed cells to the LCD
+    display->present();
+  }
+
+protected:
+  /**
+   * @brief Returns the row of the source shown at a position. If the table
+   * is sorted the rows are sorted up to one page behind the position.
+   */
+  int getRowAt(const int& position) {
+    if (sortColumn < 0) {
+      return position;
+    }
+    if (position >= sortedCount) {
+      // top-k sort: only the rows up to the end of the next page are ordered
+      const int end = std::min(position + 1 + numberOfRowsUsedForData, (int)order.size());
+      const uint8_t column = sortColumn;
+      const bool ascending = sortAscending;
+      TableSource* data = source;
+      std::partial_sort(order.begin() + sortedCount, order.begin() + end, order.end(),
+                        [data, column, ascending](const int& a, const int& b) {
+                          const int result = data->compare(a, b, column);
+                          return ascending ? result < 0 : result > 0;
+                        });
+      sortedCount = end;
+    }
+    return order[position];
+  }
+
+protected:
+  /**
+   * @brief Reads the number of rows and discards the sorted order and the
+   * cached rows
+   */
+  void resort() {
+    numberOfDataRows = source->getNumberOfRows();
+    // removed rows must not stay scrolled in, even if the next tick returns early
+    firstVisibleRow = std::min(firstVisibleRow, std::max(numberOfDataRows - numberOfRowsUsedForData, 0));
+    order.clear();
+    if (sortColumn >= 0) {
+      order.reserve(numberOfDataRows);
+      for (int i = 0; i < numberOfDataRows; i++) {
+        order.push_back(i);
+      }
+    }
+    sortedCount = 0;
+    rowsModified = true;
+    invalidateCache();
+  }
+
+protected:
+  /**
+   * @brief Forgets all cached rows
+   */
+  void invalidateCache() {
+    std::fill_n(cachedPositions, LCD_FRAME_ROWS, -1);
+    std::fill_n(dirtyCells, LCD_FRAME_ROWS, 0);
+  }
+
+protected:
+  /**
+   * @brief Draws the header row. The header of the column by which the table
+   * is sorted ends with '^' if ascending or 'v' if descending.
+   */
+  void drawHeader() {
+    int x = 0;
+    for (uint8_t column = 0; column < numberOfTableColumns; column++) {
+      drawCell(x, 0, columns[column], columns[column].header);
+      if ((column == sortColumn) && (columns[column].width > 0)) {
+        display->setCursor(x + columns[column].width - 1, 0);
+        display->write(sortAscending ? '^' : 'v');
+      }
+      x += columns[column].width;
+    }
+    if (x < numberOfColumns) {
+      display->setCursor(x, 0);
+      for (; x < numberOfColumns; x++) {
+        display->write(' ');
+      }
+    }
+    headerModified = false;
+  }
+
+protected:
+  /**
+   * @brief Draws the text of a cell, cut or padded to the width of its column
+   */
+  void drawCell(const int& x, const int& y, const Column& column, const String& text) {
+    if (x >= numberOfColumns) {
+      return;
+    }
+    const int width = std::min((int)column.width, numberOfColumns - x);
+    const int length = std::min((int)text.length(), width);
+    display->setCursor(x, y);
+    if (column.alignment == Alignment::right) {
+      for (int i = length; i < width; i++) {
+        display->write(' ');
+      }
+    }
+    display->write((const uint8_t*)text.c_str(), length);
+    if (column.alignment == Alignment::left) {
+      for (int i = length; i < width; i++) {
+        display->write(' ');
+      }
+    }
+  }
+};
+
+LCD_ASSERT_SIZE(TableView, LCD_BUDGET_TABLE_VIEW);
+} // namespace lcd
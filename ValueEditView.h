@@ -0,0 +1,578 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include "Config.h"
+#include "ViewBase.h"
+
+#include <Arduino.h>
+#include <RotaryEncoder.h>
+#include <functional>
+#include <type_traits>
+
+namespace lcd {
+/**
+ * @brief Number with a fixed number of decimals stored as integer, e.g.
+ * FixedPoint<1> with raw 214 is 21.4
+ *
+ * @tparam Decimals number of decimals
+ */
+template <uint8_t Decimals>
+struct FixedPoint {
+  /**
+   * @brief The value multiplied with 10^Decimals
+   */
+  long raw;
+
+  /**
+   * @brief Converts the value to a float
+   */
+  float toFloat() const {
+    float result = raw;
+    for (uint8_t i = 0; i < Decimals; i++) {
+      result /= 10;
+    }
+    return result;
+  }
+};
+
+/**
+ * @brief Conversion of the edited types to a scaled integer which is used
+ * internally by ValueEditView. Integers and enums are used as they are.
+ */
+template <typename T, typename Enable = void>
+struct ValueEditTraits {
+  static uint8_t getDecimals(const uint8_t& requested) {
+    return 0;
+  }
+
+  static long toRaw(const T& value, const uint8_t& decimals) {
+    return (long)value;
+  }
+
+  static T fromRaw(const long& raw, const uint8_t& decimals) {
+    return (T)raw;
+  }
+};
+
+/**
+ * @brief Floating point values are scaled by 10^decimals
+ */
+template <typename T>
+struct ValueEditTraits<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+  static uint8_t getDecimals(const uint8_t& requested) {
+    return requested;
+  }
+
+  static long toRaw(T value, const uint8_t& decimals) {
+    for (uint8_t i = 0; i < decimals; i++) {
+      value *= 10;
+    }
+    return (long)(value < 0 ? value - 0.5 : value + 0.5);
+  }
+
+  static T fromRaw(const long& raw, const uint8_t& decimals) {
+    T value = raw;
+    for (uint8_t i = 0; i < decimals; i++) {
+      value /= 10;
+    }
+    return value;
+  }
+};
+
+/**
+ * @brief Fixed point values already are scaled integers
+ */
+template <uint8_t Decimals>
+struct ValueEditTraits<FixedPoint<Decimals>> {
+  static uint8_t getDecimals(const uint8_t& requested) {
+    return Decimals;
+  }
+
+  static long toRaw(const FixedPoint<Decimals>& value, const uint8_t& decimals) {
+    return value.raw;
+  }
+
+  static FixedPoint<Decimals> fromRaw(const long& raw, const uint8_t& decimals) {
+    return FixedPoint<Decimals> {raw};
+  }
+};
+
+/**
+ * @brief View to edit a single value with the encoder. Rotating changes the
+ * value, the first click asks whether the value should be saved and the second
+ * click saves or discards the value and activates the previous view again.
+ *
+ * @tparam T the edited type: an integer, a floating point type, a FixedPoint
+ * or an enum (together with setLabels)
+ */
+template <typename T>
+class ValueEditView : public ViewBase {
+  friend class StressHarness;
+
+protected:
+  /**
+   * @brief State of the view
+   */
+  enum class State { editing, confirmSave, confirmCancel };
+
+protected:
+  /**
+   * @brief pointer to the encoder instance
+   */
+  RotaryEncoder* encoder;
+
+protected:
+  /**
+   * @brief Text shown above the value
+   */
+  const String caption;
+
+protected:
+  /**
+   * @brief Current value as scaled integer
+   */
+  long value;
+
+protected:
+  /**
+   * @brief Minimum value as scaled integer
+   */
+  long minimum;
+
+protected:
+  /**
+   * @brief Maximum value as scaled integer
+   */
+  long maximum;
+
+protected:
+  /**
+   * @brief Change per detent as scaled integer
+   */
+  long step;
+
+protected:
+  /**
+   * @brief Number of decimals shown for floating point and fixed point values
+   */
+  uint8_t decimals;
+
+protected:
+  /**
+   * @brief Names of the enum values. If set the label with the index of the
+   * value is shown instead of the number.
+   */
+  const char* const* labels;
+
+protected:
+  /**
+   * @brief Current multiplier of the step, increased by fast rotation
+   */
+  long acceleration;
+
+protected:
+  /**
+   * @brief Maximum multiplier of the step
+   */
+  long maximumAcceleration;
+
+protected:
+  /**
+   * @brief millis value of the last detent
+   */
+  uint32_t lastDetent;
+
+protected:
+  /**
+   * @brief Minimum number of milliseconds between two redraws of the value
+   */
+  unsigned long minimumRedrawInterval;
+
+protected:
+  /**
+   * @brief millis value of the last redraw of the value
+   */
+  uint32_t lastRedraw;
+
+protected:
+  /**
+   * @brief State of the view
+   */
+  State state;
+
+protected:
+  /**
+   * @brief Characters of the value which are currently drawn
+   */
+  char drawnValue[LCD_FRAME_COLUMNS + 1];
+
+protected:
+  /**
+   * @brief Called with the new value if it is saved
+   */
+  std::function<void(const T&)> onSave;
+
+protected:
+  /**
+   * @brief If set the saved value is stored persistently
+   */
+  PersistentState* persistentState;
+
+protected:
+  /**
+   * @brief Key of the value in the persistent state
+   */
+  uint8_t persistentStateKey;
+
+public:
+  /**
+   * @brief Number of display-columns
+   */
+  const int numberOfColumns;
+
+public:
+  /**
+   * @brief Number of display-rows
+   */
+  const int numberOfRows;
+
+public:
+  /**
+   * @brief Construct a new view
+   *
+   * @param display pointer to the display instance
+   * @param name The name of the view
+   * @param encoder pointer to the encoder instance
+   * @param caption text shown above the value
+   * @param numberOfColumns number of display-columns, at least 16 to show
+   * the buttons
+   * @param numberOfRows number of display-rows, at least 2
+   * @param minimum smallest allowed value
+   * @param maximum largest allowed value
+   * @param step change of the value per detent
+   * @param decimals number of shown decimals of floating point values
+   */
+  ValueEditView(LiquidCrystal_PCF8574* display,
+                const String& name,
+                RotaryEncoder* encoder,
+                const String& caption,
+                const int& numberOfColumns,
+                const int& numberOfRows,
+                const T& minimum,
+                const T& maximum,
+                const T& step,
+                const uint8_t& decimals = 2)
+    : ViewBase(display, name)
+    , encoder(encoder)
+    , caption(caption)
+    , decimals(ValueEditTraits<T>::getDecimals(decimals))
+    , labels(nullptr)
+    , acceleration(1)
+    , maximumAcceleration(100)
+    , lastDetent(0)
+    , minimumRedrawInterval(50)
+    , lastRedraw(0)
+    , state(State::editing)
+    , persistentState(nullptr)
+    , persistentStateKey(0)
+    , numberOfColumns(numberOfColumns < LCD_FRAME_COLUMNS ? numberOfColumns : LCD_FRAME_COLUMNS)
+    , numberOfRows(numberOfRows) {
+    this->minimum = ValueEditTraits<T>::toRaw(minimum, this->decimals);
+    this->maximum = ValueEditTraits<T>::toRaw(maximum, this->decimals);
+    this->step = ValueEditTraits<T>::toRaw(step, this->decimals);
+    this->value = this->minimum;
+    ViewBase::display->setSize(numberOfColumns, numberOfRows);
+    getInput().useEncoder(encoder);
+    LCD_ASSERT_SIZE(ValueEditView, LCD_BUDGET_VALUE_EDIT_VIEW);
+  }
+
+public:
+  /**
+   * @brief Copy constructor - not available
+   */
+  ValueEditView(const ValueEditView& other) = delete;
+
+public:
+  /**
+   * @brief Sets the names of the values of an enum. The array must contain
+   * one entry for each value from minimum to maximum and must stay valid.
+   */
+  void setLabels(const char* const* labels) {
+    this->labels = labels;
+  }
+
+public:
+  /**
+   * @brief Configures how fast the value changes during fast rotation
+   *
+   * @param maximumAcceleration maximum multiplier of the step, 1 disables
+   * the acceleration
+   */
+  void setMaximumAcceleration(const long& maximumAcceleration) {
+    this->maximumAcceleration = maximumAcceleration < 1 ? 1 : maximumAcceleration;
+  }
+
+public:
+  /**
+   * @brief Sets the minimum number of milliseconds between two redraws of the
+   * value. Detents in between are accumulated.
+   */
+  void setMinimumRedrawInterval(const unsigned long& interval) {
+    minimumRedrawInterval = interval;
+  }
+
+public:
+  /**
+   * @brief Sets the function which is called with the new value if it is
+   * saved
+   */
+  void setOnSave(const std::function<void(const T&)>& callback) {
+    onSave = callback;
+  }
+
+public:
+  /**
+   * @brief Stores saved values persistently. If a value was stored before it
+   * is restored immediately.
+   *
+   * @param state the persistent state or nullptr to disable storing
+   * @param key the key of the stored value
+   */
+  void setPersistentState(PersistentState* state, const uint8_t& key) {
+    persistentState = state;
+    persistentStateKey = key;
+    int32_t storedValue;
+    if (persistentState && persistentState->get(persistentStateKey, storedValue)) {
+      value = clamp(storedValue);
+    }
+  }
+
+public:
+  /**
+   * @brief Sets the value which is shown as soon as the view is activated
+   */
+  void setValue(const T& newValue) {
+    value = clamp(ValueEditTraits<T>::toRaw(newValue, decimals));
+  }
+
+public:
+  /**
+   * @brief Get the current value
+   */
+  T getValue() const {
+    return ValueEditTraits<T>::fromRaw(value, decimals);
+  }
+
+protected:
+  /**
+   * @brief called as soon as the view becomes active
+   */
+  virtual void activate() {
+    display->clear();
+    drawCaption();
+    state = State::editing;
+    acceleration = 1;
+    std::fill_n(drawnValue, LCD_FRAME_COLUMNS + 1, ' ');
+    tick(true);
+  }
+
+public:
+  /**
+   * @brief called during the loop function
+   *
+   * @param forceRedraw if true everything should be redrawn
+   */
+  virtual void tick(const bool& forceRedraw) {
+    const uint32_t now = Clock::get().millis();
+    const InputEvent event = readInput();
+
+    // Update the backlight timeout
+    if (event != InputEvent::none) {
+      if (!getBacklightTimeoutManager().delayTimeout()) {
+        getBacklightTimeoutManager().tick(display);
+        display->present();
+        return;
+      }
+    }
+    getBacklightTimeoutManager().tick(display);
+
+    bool redrawButtons = forceRedraw;
+    if ((event == InputEvent::up) || (event == InputEvent::down)) {
+      const long direction = event == InputEvent::down ? 1 : -1;
+      if (state == State::editing) {
+        // fast rotation increases the step
+        if ((now - lastDetent < 60) && (acceleration < maximumAcceleration)) {
+          acceleration = acceleration * 2 < maximumAcceleration ? acceleration * 2 : maximumAcceleration;
+        }
+        else if (now - lastDetent >= 200) {
+          acceleration = 1;
+        }
+        lastDetent = now;
+        value = clamp(value + direction * step * acceleration);
+      }
+      else {
+        state = direction > 0 ? State::confirmCancel : State::confirmSave;
+        redrawButtons = true;
+      }
+    }
+
+    if (event == InputEvent::back) {
+      // leave without saving
+      activatePreviousView();
+      return;
+    }
+    else if (event == InputEvent::select) {
+      if (state == State::editing) {
+        state = State::confirmSave;
+        redrawButtons = true;
+      }
+      else {
+        if (state == State::confirmSave) {
+          if (persistentState) {
+            persistentState->set(persistentStateKey, (int32_t)value);
+          }
+          if (onSave) {
+            onSave(getValue());
+          }
+        }
+        activatePreviousView();
+        return;
+      }
+    }
+
+    // redraw the value not more often than configured
+    if (forceRedraw || (now - lastRedraw >= minimumRedrawInterval)) {
+      drawValue(forceRedraw);
+      lastRedraw = now;
+    }
+
+    if (redrawButtons) {
+      drawButtons();
+    }
+
+    // send the changed cells to the LCD
+    display->present();
+  }
+
+protected:
+  /**
+   * @brief Limits a scaled value to the allowed range
+   */
+  long clamp(const long& raw) const {
+    return raw < minimum ? minimum : (raw > maximum ? maximum : raw);
+  }
+
+protected:
+  /**
+   * @brief Formats the value right aligned into a buffer
+   *
+   * @param buffer receives width characters
+   * @param width number of characters to format
+   */
+  void format(char* buffer, const int& width) const {
+    std::fill_n(buffer, width, ' ');
+    char* c = buffer + width;
+
+    if (labels) {
+      const char* label = labels[value - minimum];
+      const int length = strlen(label);
+      std::copy(label, label + (length < width ? length : width), buffer + (length < width ? width - length : 0));
+      return;
+    }
+
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+    int digits = 0;
+    do {
+      if ((digits == decimals) && (decimals != 0) && (c > buffer)) {
+        *--c = '.';
+      }
+      if (c > buffer) {
+        *--c = '0' + (magnitude % 10);
+      }
+      magnitude /= 10;
+      digits++;
+    } while ((magnitude != 0) || (digits <= decimals));
+    if ((value < 0) && (c > buffer)) {
+      *--c = '-';
+    }
+  }
+
+protected:
+  /**
+   * @brief Draws the characters of the value which changed since the last
+   * call
+   *
+   * @param fullRedraw if true all characters are drawn
+   */
+  void drawValue(const bool& fullRedraw) {
+    const int width = numberOfColumns - 1;
+    char formatted[LCD_FRAME_COLUMNS];
+    format(formatted, width);
+
+    for (int column = 0; column < width; column++) {
+      if (fullRedraw || (formatted[column] != drawnValue[column])) {
+        // write the run of changed characters
+        int end = column + 1;
+        while ((end < width) && (fullRedraw || (formatted[end] != drawnValue[end]))) {
+          end++;
+        }
+        display->setCursor(column, 1);
+        display->write(formatted + column, end - column);
+        std::copy(formatted + column, formatted + end, drawnValue + column);
+        column = end;
+      }
+    }
+  }
+
+protected:
+  /**
+   * @brief Draws the save and cancel buttons
+   */
+  void drawButtons() {
+    const uint8_t row = numberOfRows > 2 ? numberOfRows - 1 : 0;
+    const auto space = (numberOfColumns - 14) / 3;
+    if (state == State::editing) {
+      if (row == 0) {
+        drawCaption();
+      }
+      else {
+        display->setCursor(0, row);
+        for (int i = 0; i < numberOfColumns; i++) {
+          display->print(' ');
+        }
+      }
+      return;
+    }
+
+    display->setCursor(0, row);
+
+    for (int i = 0; i < space; i++) {
+      display->print(' ');
+    }
+    display->print(state == State::confirmSave ? ">Save<" : " Save ");
+    for (int i = 0; i < space; i++) {
+      display->print(' ');
+    }
+    display->print(state == State::confirmCancel ? ">Cancel<" : " Cancel ");
+    // on two rows the buttons replace the caption
+    for (int i = 14 + 2 * space; i < numberOfColumns; i++) {
+      display->print(' ');
+    }
+  }
+
+protected:
+  /**
+   * @brief Draws the caption into the first row, cut to the width of the
+   * display
+   */
+  void drawCaption() {
+    display->setCursor(0, 0);
+    for (int i = 0; i < numberOfColumns; i++) {
+      display->print(i < (int)caption.length() ? caption[i] : ' ');
+    }
+  }
+};
+} // namespace lcd
@@ -4,8 +4,23 @@
  */
 #pragma once
 
+#include "Frame.h"
+#include "InputManager.h"
+#include "Log.h"
+#include "PersistentState.h"
+
 #include <Arduino.h>
 #include <LiquidCrystal_PCF8574.h>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+/**
+ * Number of input events each view can bind to an action
+ */
+#ifndef LCD_VIEW_MAX_BINDINGS
+#define LCD_VIEW_MAX_BINDINGS 3
+#endif
 
 namespace lcd {
 
@@ -24,7 +39,7 @@ protected:
     /**
      * @brief millis value after which the display should turn off
      */
-    unsigned long nextTimeout = 0;
+    uint32_t nextTimeout = 0;
 
     /**
      * @brief configured value after which amount of milliseconds the backlight
@@ -40,8 +55,8 @@ protected:
     /**
      * @brief this value is set to true as soon as the timout occurred. If this
      * is true the display is turned off no matter what the evaluation of
-     * nextTimeout says. The reason for this is that millis can overflow which
-     * would turn the backlight back on again.
+     * nextTimeout says. Without it the comparison would turn the backlight
+     * back on after half of the range of millis.
      */
     bool timedOut = false;
 
@@ -49,11 +64,11 @@ protected:
     /**
      * @brief Must be called in each tick call.
      */
-    void tick(LiquidCrystal_PCF8574* display) {
+    void tick(Frame* display) {
       // check if this class should do anything
       if (timeout != 0) {
         // check if the a timeout is active / occurred
-        if (timedOut || (nextTimeout < millis())) {
+        if (timedOut || Clock::reached(Clock::get().millis(), nextTimeout)) {
           timedOut = true;
           if (displayCurrentlyOn) {
             display->setBacklight(0);
@@ -76,12 +91,30 @@ protected:
      * @return the current state of the backlight
      */
     bool delayTimeout() {
-      nextTimeout = millis() + timeout;
+      nextTimeout = Clock::get().millis() + timeout;
       timedOut = false;
       return displayCurrentlyOn;
     }
   };
 
+protected:
+  /**
+   * @brief Where the last activated view is stored persistently
+   */
+  struct LastViewStorage {
+    PersistentState* state = nullptr;
+    uint8_t key = 0;
+  };
+
+protected:
+  /**
+   * @brief Returns the singleton of the LastViewStorage.
+   */
+  static LastViewStorage& getLastViewStorage() {
+    static LastViewStorage storage;
+    return storage;
+  }
+
 protected:
   /**
    * @brief Returns the singleton of the BacklightTimeoutManager.
@@ -91,11 +124,60 @@ protected:
     return manager;
   }
 
+public:
+  /**
+   * @brief Returns the frame of the first LCD. All views of this LCD draw into
+   * it and only the changes of the frame are sent to the LCD.
+   */
+  static Frame& getFrame() {
+    static Frame frame;
+    return frame;
+  }
+
+public:
+  /**
+   * @brief Returns the frame of an LCD. The first LCD uses the frame returned
+   * by getFrame(), every further LCD gets its own frame. So views on separate
+   * displays do not overwrite each other.
+   *
+   * @param lcd the LCD, nullptr returns the frame of the first LCD
+   */
+  static Frame& getFrame(LiquidCrystal_PCF8574* lcd) {
+    Frame& first = getFrame();
+    if (!lcd || (first.getDisplay() == lcd)) {
+      return first;
+    }
+    else if (!first.getDisplay()) {
+      first.setDisplay(lcd);
+      return first;
+    }
+    static std::vector<Frame*> frames;
+    for (Frame* frame : frames) {
+      if (frame->getDisplay() == lcd) {
+        return *frame;
+      }
+    }
+    Frame* frame = new Frame();
+    frame->setDisplay(lcd);
+    frames.push_back(frame);
+    return *frame;
+  }
+
+public:
+  /**
+   * @brief Returns the singleton of the input manager from which all views
+   * read their input events.
+   */
+  static InputManager& getInput() {
+    static InputManager input;
+    return input;
+  }
+
 protected:
   /**
-   * @brief Pointer to the LCD instance
+   * @brief Pointer to the frame in which the view draws
    */
-  LiquidCrystal_PCF8574* display;
+  Frame* display;
 
 protected:
   /**
@@ -109,22 +191,39 @@ protected:
    */
   const String name;
 
+protected:
+  /**
+   * @brief An input event bound to an action
+   */
+  struct InputBinding {
+    InputEvent event = InputEvent::none;
+    std::function<void()> action;
+  };
+
+protected:
+  /**
+   * @brief Input events which are handled by actions instead of the view
+   */
+  InputBinding bindings[LCD_VIEW_MAX_BINDINGS];
+
 #pragma region Special characters
 public:
   /**
-   * @brief Special character for Scrollbar Top
+   * @brief Special character for the scrollbar cell containing the upper
+   * end of the thumb. Its bitmap is generated by the MenuView.
    */
   const static uint8_t scScrollbarTop = 0;
 
 public:
   /**
-   * @brief Special character for Scrollbar Middle
+   * @brief Special character for a scrollbar cell without thumb
    */
   const static uint8_t scScrollbarMiddle = 1;
 
 public:
   /**
-   * @brief Special character for Scrollbar Bottom
+   * @brief Special character for the scrollbar cell containing the lower
+   * end of the thumb. Its bitmap is generated by the MenuView.
    */
   const static uint8_t scScrollbarBottom = 2;
 
@@ -151,17 +250,25 @@ public:
    * @brief Special character for WIFI signal strength 3 (best)
    */
   const static uint8_t scWifiSignal3 = 6;
+
+public:
+  /**
+   * @brief Special character for a scrollbar cell which is completely covered
+   * by the thumb
+   */
+  const static uint8_t scScrollbarThumb = 7;
 #pragma endregion
 
 public:
   /**
    * @brief Construct a view object
    *
-   * @param display pointer to the LCD instance
+   * @param display pointer to the LCD instance, views of the same LCD share
+   * its frame
    * @param name The name of the view
    */
   ViewBase(LiquidCrystal_PCF8574* display, const String& name)
-    : display(display)
+    : display(&getFrame(display))
     , previousView(nullptr)
     , name(name) {}
 
@@ -178,7 +285,11 @@ public:
   ViewBase(ViewBase&& other) noexcept
     : display(std::move(other.display))
     , previousView(std::move(other.previousView))
-    , name(std::move(other.name)) {}
+    , name(std::move(other.name)) {
+    for (int i = 0; i < LCD_VIEW_MAX_BINDINGS; i++) {
+      bindings[i] = std::move(other.bindings[i]);
+    }
+  }
 
 public:
   /**
@@ -204,11 +315,12 @@ public:
       view->previousView = getCurrentView();
       getCurrentView() = view;
       if (view) {
-        Serial.print("Activate view ");
-        Serial.println(view->name);
+        LCD_LOG_INFO("Activate view ", view->name);
+        storeLastView(view);
         view->activate();
         getBacklightTimeoutManager().delayTimeout();
         getBacklightTimeoutManager().tick(view->display);
+        view->display->present();
       }
     }
     else {
@@ -216,6 +328,50 @@ public:
     }
   }
 
+public:
+  /**
+   * @brief Stores the name of each activated view persistently, so it can be
+   * restored after a reboot using restoreLastView.
+   *
+   * @param state the persistent state or nullptr to disable storing
+   * @param key the key of the stored value
+   */
+  static void setLastViewState(PersistentState* state, const uint8_t& key) {
+    getLastViewStorage().state = state;
+    getLastViewStorage().key = key;
+  }
+
+protected:
+  /**
+   * @brief Stores the name of the view which becomes active if enabled by
+   * setLastViewState
+   */
+  static void storeLastView(const ViewBase* view) {
+    if (getLastViewStorage().state) {
+      getLastViewStorage().state->set(getLastViewStorage().key, view->getNameHash());
+    }
+  }
+
+public:
+  /**
+   * @brief Activates the view which was active before the reboot
+   *
+   * @param views the views which can be restored
+   * @return false if none of the views was active before the reboot
+   */
+  static bool restoreLastView(std::initializer_list<ViewBase*> views) {
+    uint16_t hash;
+    if (getLastViewStorage().state && getLastViewStorage().state->get(getLastViewStorage().key, hash)) {
+      for (ViewBase* view : views) {
+        if (view && (view->getNameHash() == hash)) {
+          activateView(view);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
 public:
   /**
    * @brief Set the Backlight Timeout. To disable the timeout set the value to 0
@@ -250,6 +406,48 @@ public:
     return name;
   }
 
+public:
+  /**
+   * @brief Get a 16 bit hash of the name which identifies the view in the
+   * persistent state
+   */
+  uint16_t getNameHash() const {
+    uint16_t hash = 0x811C;
+    for (const char* c = name.c_str(); *c; c++) {
+      hash = (hash ^ (uint8_t)*c) * 0x0101;
+    }
+    return hash;
+  }
+
+public:
+  /**
+   * @brief Binds an input event to an action which is called instead of the
+   * default handling of the view while the view is active, e.g. a long press
+   * to activate a main menu.
+   *
+   * @param event the input event
+   * @param action the action or nullptr to remove the binding
+   * @return false if all LCD_VIEW_MAX_BINDINGS bindings are used
+   */
+  bool bind(const InputEvent& event, std::function<void()> action) {
+    InputBinding* freeBinding = nullptr;
+    for (auto& binding : bindings) {
+      if (binding.event == event) {
+        freeBinding = &binding;
+        break;
+      }
+      else if (!freeBinding && (binding.event == InputEvent::none)) {
+        freeBinding = &binding;
+      }
+    }
+    if (!freeBinding) {
+      return false;
+    }
+    freeBinding->event = action ? event : InputEvent::none;
+    freeBinding->action = std::move(action);
+    return true;
+  }
+
 public:
   /**
    * @brief activates the previous view
@@ -257,9 +455,10 @@ public:
   void activatePreviousView() {
     if (previousView) {
       getCurrentView() = previousView;
-      Serial.print("Activate previous view ");
-      Serial.println(previousView->name);
+      LCD_LOG_INFO("Activate previous view ", previousView->name);
+      storeLastView(previousView);
       previousView->activate();
+      previousView->display->present();
     }
   }
 
@@ -277,11 +476,56 @@ public:
    */
   virtual void tick(const bool& forceRedraw) = 0;
 
+protected:
+  /**
+   * @brief Returns the next input event for the view. Bound events call
+   * their action and are not returned, all other events are passed through
+   * translateInput.
+   */
+  InputEvent readInput() {
+    const InputEvent event = getInput().getEvent();
+    if (event == InputEvent::none) {
+      return event;
+    }
+    for (auto& binding : bindings) {
+      if (binding.event == event) {
+        // the first input only turns the backlight on
+        if (getBacklightTimeoutManager().delayTimeout()) {
+          binding.action();
+        }
+        return InputEvent::none;
+      }
+    }
+    return translateInput(event);
+  }
+
+protected:
+  /**
+   * @brief Maps gestures which are not handled by a view to the basic events.
+   * A long press leaves the view, press-and-turn moves like a rotation and a
+   * double click selects.
+   */
+  virtual InputEvent translateInput(const InputEvent& event) {
+    switch (event) {
+    case InputEvent::longPress:
+      return InputEvent::back;
+    case InputEvent::pressTurnUp:
+      return InputEvent::up;
+    case InputEvent::pressTurnDown:
+      return InputEvent::down;
+    case InputEvent::doubleClick:
+      return InputEvent::select;
+    default:
+      return event;
+    }
+  }
+
 protected:
   /**
    * @brief writes the special characters to the display
    */
   void initializeSpecialCharacters() {
+#if LCD_FEATURE_GLYPHS
     if (display) {
       byte customChar[8];
       std::fill_n(customChar, 8, 0);
@@ -299,16 +543,10 @@ protected:
 
       std::fill_n(customChar, 8, B10001);
       display->createChar(scScrollbarMiddle, customChar);
-      customChar[0] = B00100;
-      customChar[1] = B01110;
-      customChar[2] = B11111;
-      display->createChar(scScrollbarTop, customChar);
-      std::fill_n(customChar, 5, B10001);
-      customChar[5] = B11111;
-      customChar[6] = B01110;
-      customChar[7] = B00100;
-      display->createChar(scScrollbarBottom, customChar);
+      std::fill_n(customChar, 8, B11111);
+      display->createChar(scScrollbarThumb, customChar);
     }
+#endif
   }
 };
 } // namespace lcd
@@ -75,4 +75,7 @@ void setup() {
  */
 void loop() {
   testMenu.tick();
+
+  // send buffered log messages without blocking the menu
+  lcd::Log::getInstance().flush(Serial);
 }
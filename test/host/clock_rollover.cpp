@@ -0,0 +1,92 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ *
+ * Simulates 60 days of uptime starting shortly before the wraparound of
+ * millis, so the time wraps around twice. Checks that the backlight timeout
+ * and the marquee of a menu title behave the same before and after each
+ * wraparound. Exits with 1 if a check fails.
+ */
+#include "MenuView.h"
+
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(condition, time)                                                        \
+  if (!(condition)) {                                                                 \
+    if (failures < 10) {                                                              \
+      printf("%s:%d: failed at %lu: %s\n", __FILE__, __LINE__, (unsigned long)(time), \
+             #condition);                                                             \
+    }                                                                                 \
+    failures++;                                                                       \
+  }
+
+int main() {
+  // the backlight timeout of the first input ends after the wraparound, the
+  // second wraparound happens during the 50ms ticks of an hour
+  const uint32_t start = 0xFFFFFFFF - 30000;
+  const uint32_t backlightTimeout = 60000;
+  const uint32_t days = 60;
+  // every hour starts with an input event followed by 5 minutes of 50ms
+  // ticks, the rest of the hour is simulated with 1s ticks
+  const uint32_t activeTime = 300000;
+  const uint32_t activeStep = 50;
+  const uint32_t idleStep = 1000;
+
+  lcd::SimulatedClock clock(start);
+  lcd::Clock::set(&clock);
+
+  LiquidCrystal_PCF8574 display(0x27);
+  RotaryEncoder encoder(1, 2, 3);
+  // bounce marquee of the title: a step every 500ms, 1000ms at its ends
+  lcd::MenuView menu(&display, "menu", &encoder, "Rollover soak test with a long title", 20, 4);
+  menu.createMenuItem("Entry");
+  lcd::ViewBase::setBacklightTimeout(backlightTimeout);
+  lcd::ViewBase::activateView(&menu);
+
+  unsigned long wraparounds = 0;
+  unsigned long steps = 0;
+  uint32_t previous = clock.millis();
+  for (uint32_t hour = 0; hour < days * 24; hour++) {
+    // the first input only turns the backlight on
+    const uint32_t input = clock.millis();
+    lcd::ViewBase::getInput().inject(lcd::InputEvent::up);
+    menu.tick(false);
+    CHECK(lcd::ViewBase::isBacklightOn() && (display.backlight == 1), input);
+
+    char title[21] = {0};
+    memcpy(title, display.screen[0], 20);
+    uint32_t lastStep = 0;
+    bool stepSeen = false;
+    for (uint32_t elapsed = activeStep; elapsed < 3600000; elapsed += elapsed < activeTime ? activeStep : idleStep) {
+      clock.advance(elapsed < activeTime ? activeStep : idleStep);
+      const uint32_t now = clock.millis();
+      wraparounds += now < previous ? 1 : 0;
+      previous = now;
+      menu.tick(false);
+
+      const bool expectedOn = now - input < backlightTimeout;
+      CHECK((lcd::ViewBase::isBacklightOn() == expectedOn) && (display.backlight == (expectedOn ? 1 : 0)), now);
+
+      if (elapsed < activeTime) {
+        if (memcmp(title, display.screen[0], 20) != 0) {
+          memcpy(title, display.screen[0], 20);
+          if (stepSeen) {
+            CHECK((now - lastStep == 500) || (now - lastStep == 1000), now);
+          }
+          stepSeen = true;
+          lastStep = now;
+          steps++;
+        }
+        else if (stepSeen) {
+          CHECK(now - lastStep < 1000, now);
+        }
+      }
+    }
+  }
+
+  CHECK(wraparounds == 2, previous);
+  printf("clock_rollover: %lu wraparounds, %lu marquee steps: %s\n", wraparounds, steps, failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
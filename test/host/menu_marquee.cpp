@@ -0,0 +1,65 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ *
+ * Ticker items which fit exactly into a row of a 20x4 menu. Adding a fourth
+ * item shows the scrollbar, so the rows become one character shorter while
+ * the items are redrawn without an animation step. Exits with 1 if a row is
+ * not drawn as expected.
+ */
+#include "MenuView.h"
+
+#include <stdio.h>
+#include <string>
+
+static LiquidCrystal_PCF8574 display(0x27);
+static RotaryEncoder encoder(1, 2, 3);
+static int failures = 0;
+
+/**
+ * Returns the first columns of a row of the LCD
+ */
+static std::string getRow(const int& row, const int& columns) {
+  return std::string((const char*)display.screen[row], columns);
+}
+
+/**
+ * Compares a row of the LCD with the expected text
+ */
+static void check(const char* name, const int& row, const std::string& expected) {
+  const std::string shown = getRow(row, expected.length());
+  if (shown != expected) {
+    printf("%s: row %d is \"%s\", expected \"%s\"\n", name, row, shown.c_str(), expected.c_str());
+    failures++;
+  }
+}
+
+/**
+ * Shows three items of 19 characters, adds a fourth one and checks the rows
+ * after the next tick
+ */
+static void run(const char* name, const bool& animateSelectedOnly) {
+  lcd::MenuView menu(&display, name, &encoder, "Title", 20, 4);
+  menu.setAnimateSelectedOnly(animateSelectedOnly);
+  for (const char* text : {"First ticker item 1", "Second ticker itm 2", "Third ticker item 3"}) {
+    menu.createMenuItem(text).setMarquee(lcd::MenuView::LongEntry::MarqueeMode::ticker, 300, 2);
+  }
+  lcd::ViewBase::activateView(&menu);
+  menu.tick(false);
+
+  menu.createMenuItem("Fourth item").setMarquee(lcd::MenuView::LongEntry::MarqueeMode::ticker, 300, 2);
+  menu.tick(false);
+  lcd::ViewBase::activateView(nullptr);
+
+  // the items are cut until their animation moves
+  check(name, 1, ">First ticker item ");
+  check(name, 2, " Second ticker itm ");
+  check(name, 3, " Third ticker item ");
+}
+
+int main() {
+  run("all items animated", false);
+  run("selected item animated", true);
+  printf("menu_marquee: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
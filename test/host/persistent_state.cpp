@@ -0,0 +1,202 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ *
+ * Restores, compacts and interrupts the PersistentState on the host and
+ * restores the last view. Exits with 1 if a check fails.
+ */
+#include "MenuView.h"
+#include "PersistentState.h"
+
+#include <stdio.h>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition)                                         \
+  if (!(condition)) {                                            \
+    printf("%s:%d: failed: %s\n", __FILE__, __LINE__, #condition); \
+    failures++;                                                  \
+  }
+
+/**
+ * Storage in RAM which drops all writes after a number of writes, like a
+ * board which loses power during a commit
+ */
+class InterruptedStorage : public lcd::StorageBackend {
+public:
+  std::vector<uint8_t> content;
+  long writesLeft = -1;
+
+  InterruptedStorage(const size_t& length)
+    : content(length, 0xFF) {}
+
+  virtual size_t size() const {
+    return content.size();
+  }
+
+  virtual uint8_t read(const size_t& address) {
+    return content[address];
+  }
+
+  virtual void write(const size_t& address, const uint8_t& value) {
+    if (writesLeft != 0) {
+      content[address] = value;
+      writesLeft -= writesLeft > 0 ? 1 : 0;
+    }
+  }
+};
+
+/**
+ * Values survive closing and opening the file
+ */
+static void testRestore(const char* path) {
+  remove(path);
+  {
+    lcd::FileStorage storage(path, 64);
+    lcd::PersistentState state(&storage);
+    state.begin();
+    int32_t value = 0;
+    CHECK(!state.get(1, value));
+    state.set(1, (int32_t)-12345);
+    state.set(2, (uint8_t)7);
+    state.set(3, (uint16_t)65000);
+    state.commit();
+  }
+
+  lcd::FileStorage storage(path, 64);
+  lcd::PersistentState state(&storage);
+  state.begin();
+  int32_t value1 = 0;
+  uint8_t value2 = 0;
+  uint16_t value3 = 0;
+  CHECK(state.get(1, value1) && (value1 == -12345));
+  CHECK(state.get(2, value2) && (value2 == 7));
+  CHECK(state.get(3, value3) && (value3 == 65000));
+  // the length is part of the value
+  CHECK(!state.get(2, value1));
+}
+
+/**
+ * Full pages are compacted into the other page and the values survive
+ */
+static void testCompaction(const char* path) {
+  remove(path);
+  bool usedPages[2] = {false, false};
+  for (int32_t i = 0; i < 100; i++) {
+    lcd::FileStorage storage(path, 64);
+    lcd::PersistentState state(&storage);
+    state.begin();
+    if (i > 0) {
+      int32_t value1 = 0;
+      int32_t value2 = 0;
+      CHECK(state.get(1, value1) && (value1 == i - 1));
+      CHECK(state.get(2, value2) && (value2 == 1000 - (i - 1)));
+    }
+    state.set(1, i);
+    state.set(2, 1000 - i);
+    state.commit();
+    for (uint8_t page = 0; page < 2; page++) {
+      usedPages[page] |= storage.read(page * 32) == 0x4C;
+    }
+  }
+  CHECK(usedPages[0] && usedPages[1]);
+}
+
+/**
+ * A commit which is interrupted after any number of writes leaves either
+ * the old or the new value of every key
+ */
+static void testInterruptedCommit() {
+  for (int round = 0; round < 20; round++) {
+    // the rounds start at different positions of the page, some of them
+    // interrupt a compaction
+    InterruptedStorage prepared(64);
+    {
+      lcd::PersistentState state(&prepared);
+      state.begin();
+      for (int32_t i = 0; i <= round; i++) {
+        state.set(1, i);
+        state.set(2, (uint8_t)i);
+        state.commit();
+      }
+    }
+
+    for (long writes = 0;; writes++) {
+      InterruptedStorage storage = prepared;
+      lcd::PersistentState state(&storage);
+      state.begin();
+      state.set(1, (int32_t)-1);
+      state.set(2, (uint8_t)0xEE);
+      storage.writesLeft = writes;
+      state.commit();
+      const bool complete = storage.writesLeft != 0;
+
+      // reboot
+      storage.writesLeft = -1;
+      lcd::PersistentState restored(&storage);
+      restored.begin();
+      int32_t value1 = 0;
+      uint8_t value2 = 0;
+      CHECK(restored.get(1, value1) && ((value1 == round) || (value1 == -1)));
+      CHECK(restored.get(2, value2) && ((value2 == round) || (value2 == 0xEE)));
+      if (complete) {
+        CHECK((value1 == -1) && (value2 == 0xEE));
+      }
+
+      // the state can still be changed after the reboot
+      restored.set(1, (int32_t)42);
+      restored.commit();
+      lcd::PersistentState again(&storage);
+      again.begin();
+      CHECK(again.get(1, value1) && (value1 == 42));
+
+      if (complete) {
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * After going back to a menu the menu is restored and not the submenu which
+ * was left
+ */
+static void testLastView() {
+  LiquidCrystal_PCF8574 display(0x27);
+  RotaryEncoder encoder(1, 2, 3);
+  lcd::MenuView mainMenu(&display, "Main", &encoder, "Main", 20, 4);
+  lcd::MenuView settings(&display, "Settings", &encoder, "Settings", 20, 4);
+  InterruptedStorage storage(64);
+  {
+    lcd::PersistentState state(&storage);
+    state.begin();
+    lcd::ViewBase::setLastViewState(&state, 5);
+    lcd::ViewBase::activateView(&mainMenu);
+    lcd::ViewBase::activateView(&settings);
+    settings.activatePreviousView();
+    CHECK(lcd::ViewBase::getCurrentView() == &mainMenu);
+    state.commit();
+  }
+
+  // reboot
+  lcd::PersistentState state(&storage);
+  state.begin();
+  lcd::ViewBase::setLastViewState(&state, 5);
+  lcd::ViewBase::activateView(nullptr);
+  CHECK(lcd::ViewBase::restoreLastView({&mainMenu, &settings}));
+  CHECK(lcd::ViewBase::getCurrentView() == &mainMenu);
+  lcd::ViewBase::setLastViewState(nullptr, 0);
+  lcd::ViewBase::activateView(nullptr);
+}
+
+int main() {
+  const char* path = "persistent_state.bin";
+  testRestore(path);
+  testCompaction(path);
+  testInterruptedCommit();
+  testLastView();
+  remove(path);
+  printf("persistent_state: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
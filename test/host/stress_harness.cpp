@@ -0,0 +1,468 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ *
+ * Runs the StressHarness on the menus (MenuView, StaticMenuView,
+ * MenuFileView), TableView, ValueEditView, SparklineView, the bars, the
+ * dialogs and on views whose state is persisted, using several display
+ * geometries, and checks the layout of the dialogs. The output on stdout does
+ * not depend on the speed of the host and is compared with
+ * stress_harness.expected by 'make check'. Throughput and the longest tick
+ * are reported on stderr.
+ *
+ * Usage: stress_harness [ticks per run]
+ */
+
+// 8 rows to test displays with more rows than a dialog has text rows
+#define LCD_FRAME_ROWS 8
+
+#include "BarGraph.h"
+#include "DialogOk.h"
+#include "DialogYesNo.h"
+#include "DialogYesNoBack.h"
+#include "MenuFile.h"
+#include "MenuView.h"
+#include "PersistentState.h"
+#include "SparklineView.h"
+#include "StaticMenu.h"
+#include "StressHarness.h"
+#include "TableView.h"
+#include "ValueEditView.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static LiquidCrystal_PCF8574 display(0x27);
+static RotaryEncoder encoder(1, 2, 3);
+static int failures = 0;
+
+/**
+ * Table whose number of rows is changed while it is shown
+ */
+class Source : public lcd::TableSource {
+public:
+  int numberOfRows = 50;
+
+  virtual int getNumberOfRows() {
+    return numberOfRows;
+  }
+
+  virtual String getCell(const int& row, const uint8_t& column) {
+    return String(row * (column + 1));
+  }
+};
+
+/**
+ * Persistent state in RAM
+ */
+class RamStorage : public lcd::StorageBackend {
+public:
+  uint8_t content[256];
+
+  RamStorage() {
+    std::fill_n(content, sizeof(content), 0xFF);
+  }
+
+  virtual size_t size() const {
+    return sizeof(content);
+  }
+
+  virtual uint8_t read(const size_t& address) {
+    return content[address];
+  }
+
+  virtual void write(const size_t& address, const uint8_t& value) {
+    content[address] = value;
+  }
+};
+
+/**
+ * View showing a horizontal bar in the first row and a vertical bar in the
+ * last column. The value is changed by the encoder, a click activates the
+ * previous view.
+ */
+class BarView : public lcd::ViewBase {
+public:
+  lcd::ProgressBar progressBar;
+  lcd::VerticalBar verticalBar;
+  long value = 0;
+
+  BarView(LiquidCrystal_PCF8574* lcd, RotaryEncoder* encoder, const int& columns, const int& rows)
+    : ViewBase(lcd, "bars")
+    , progressBar(0, 0, columns - 1, 0)
+    , verticalBar(columns - 1, rows - 1, rows, 4) {
+    display->setSize(columns, rows);
+    getInput().useEncoder(encoder);
+  }
+
+  virtual void tick(const bool& forceRedraw) {
+    const lcd::InputEvent event = readInput();
+    if ((event == lcd::InputEvent::select) || (event == lcd::InputEvent::back)) {
+      activatePreviousView();
+      return;
+    }
+    else if (event == lcd::InputEvent::up) {
+      value = std::min(value + 7, 100L);
+    }
+    else if (event == lcd::InputEvent::down) {
+      value = std::max(value - 7, 0L);
+    }
+    progressBar.setValue(display, value, 100);
+    verticalBar.setValue(display, 100 - value, 100);
+    display->present();
+  }
+
+protected:
+  virtual void activate() {
+    display->clear();
+    progressBar.initializeSpecialCharacters(display);
+    verticalBar.initializeSpecialCharacters(display);
+    tick(true);
+  }
+};
+
+/**
+ * Returns a menu file with a root menu of 12 items and a submenu
+ */
+static std::vector<uint8_t> createMenuFile() {
+  struct Item {
+    const char* text;
+    uint8_t type;
+    uint16_t target;
+  };
+  const std::vector<std::pair<const char*, std::vector<Item>>> menus = {
+    {"Menu file with a long title",
+     {{"Action 1", 0, 1}, {"Submenu", 1, 1}, {"Action 3", 0, 3}, {"An action with a long text", 0, 4},
+      {"Action 5", 0, 5}, {"Action 6", 0, 6}, {"Action 7", 0, 7}, {"Action 8", 0, 8},
+      {"Action 9", 0, 9}, {"Action 10", 0, 10}, {"Action 11", 0, 11}, {"Action 12", 0, 12}}},
+    {"Submenu", {{"Back", 2, 0}, {"Sub action", 0, 13}}}};
+
+  std::vector<uint8_t> file = {'L', 'C', 'D', 'M', 1, 0, (uint8_t)menus.size(), 0};
+  auto append32 = [&](const uint32_t& value) {
+    for (int i = 0; i < 4; i++) {
+      file.push_back((value >> (8 * i)) & 0xFF);
+    }
+  };
+  auto set32 = [&](const size_t& position, const uint32_t& value) {
+    for (int i = 0; i < 4; i++) {
+      file[position + i] = (value >> (8 * i)) & 0xFF;
+    }
+  };
+  auto appendText = [&](const char* text) {
+    file.push_back(strlen(text));
+    file.insert(file.end(), text, text + strlen(text));
+  };
+
+  const size_t menuOffsets = file.size();
+  file.resize(file.size() + 4 * menus.size());
+  for (size_t menu = 0; menu < menus.size(); menu++) {
+    set32(menuOffsets + 4 * menu, file.size());
+    const size_t menuHeader = file.size();
+    const std::vector<Item>& items = menus[menu].second;
+    append32(0);
+    file.insert(file.end(), {(uint8_t)items.size(), 0, 0, 0});
+    const size_t itemsStart = file.size();
+    for (const Item& item : items) {
+      append32(0);
+      file.insert(file.end(), {item.type, 0, (uint8_t)item.target, 0});
+    }
+    set32(menuHeader, file.size());
+    appendText(menus[menu].first);
+    for (size_t item = 0; item < items.size(); item++) {
+      set32(itemsStart + 8 * item, file.size());
+      appendText(items[item].text);
+    }
+  }
+  return file;
+}
+
+static void staticAction() {}
+
+constexpr lcd::StaticMenuEntry staticMainItems[] = {
+  lcd::menuAction("Start", &staticAction),
+  lcd::menuLink("Settings", 1),
+  lcd::menuAction("A static item with a long text", &staticAction),
+  lcd::menuAction("Stop", &staticAction),
+  lcd::menuAction("Pause", &staticAction),
+  lcd::menuAction("Resume", &staticAction),
+};
+constexpr lcd::StaticMenuEntry staticSettingsItems[] = {
+  lcd::menuAction("Reset", &staticAction),
+  lcd::menuBack("Back"),
+};
+constexpr lcd::StaticMenu staticMenus[] = {
+  lcd::staticMenu("Static menu", staticMainItems),
+  lcd::staticMenu("Settings", staticSettingsItems),
+};
+
+/**
+ * Prints the result of a run. Throughput and the longest tick depend on the
+ * host and are printed to stderr.
+ */
+static void print(const int& columns, const int& rows, const char* view, const lcd::StressHarness::Report& report) {
+  printf("%2dx%d %-16s %lu ticks, %lu violations", columns, rows, view, report.ticks, report.violations);
+  if (report.violations) {
+    printf(", first at tick %lu: %s", report.firstViolationTick, report.firstViolation.c_str());
+    failures++;
+  }
+  printf("\n");
+  fprintf(stderr, "%2dx%d %-16s %.0f ticks/s, longest tick %lu us\n", columns, rows, view, report.ticksPerSecond,
+          (unsigned long)report.longestTick);
+}
+
+/**
+ * Prints that a view does not support a geometry
+ */
+static void printUnsupported(const int& columns, const int& rows, const char* view) {
+  printf("%2dx%d %-16s not supported\n", columns, rows, view);
+}
+
+/**
+ * Returns a row of the frame
+ */
+static std::string getRow(const int& row) {
+  const lcd::Frame& frame = lcd::ViewBase::getFrame();
+  std::string text;
+  for (uint8_t column = 0; column < frame.getNumberOfColumns(); column++) {
+    text += (char)frame.getCell(column, row);
+  }
+  return text;
+}
+
+/**
+ * Shows a dialog with its first button selected and checks that its text rows
+ * and its buttons are drawn inside the display
+ */
+static void checkDialog(const int& columns,
+                        const int& rows,
+                        const char* name,
+                        const std::function<void()>& show,
+                        const std::vector<const char*>& buttons) {
+  lcd::Frame& frame = lcd::ViewBase::getFrame();
+  const uint16_t droppedCharacters = frame.getDroppedCharacters();
+  show();
+  lcd::ViewBase::getCurrentView()->tick(true);
+
+  bool ok = frame.getDroppedCharacters() == droppedCharacters;
+  // the text has more lines than any display has rows, at most 3 are shown
+  const int textRows = std::min(rows - 1, 3);
+  for (int row = 0; row < textRows; row++) {
+    ok = ok && (getRow(row) == std::string(("Line " + String(row + 1) + " of the dialog text").c_str()).substr(0, columns));
+  }
+  for (int row = textRows; row < rows - 1; row++) {
+    ok = ok && (getRow(row) == std::string(columns, ' '));
+  }
+  for (const char* button : buttons) {
+    ok = ok && (getRow(rows - 1).find(button) != std::string::npos);
+  }
+  printf("%2dx%d %-16s layout %s\n", columns, rows, name, ok ? "ok" : "FAILED");
+  failures += ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  const unsigned long ticks = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+  const int geometries[][2] = {{8, 1}, {16, 2}, {20, 4}, {20, 2}, {16, 4}, {20, 8}};
+  const String dialogText = "Line 1 of the dialog text\nLine 2 of the dialog text\nLine 3 of the dialog text\n"
+                            "Line 4 of the dialog text\nLine 5 of the dialog text";
+  // generous, so only hangs and unbounded work fail on a loaded host
+  const uint32_t tickLimit = 50000;
+  const std::vector<uint8_t> menuFile = createMenuFile();
+
+  for (const auto& geometry : geometries) {
+    const int columns = geometry[0];
+    const int rows = geometry[1];
+
+    {
+      // items are hidden, disabled and changed while the menu is shown
+      lcd::MenuView menu(&display, "menu", &encoder, "Title", columns, rows);
+      std::vector<lcd::MenuView::MenuItem*> items;
+      for (int i = 0; i < 30; i++) {
+        items.push_back(&menu.createMenuItem(i % 5 ? "Item " + String(i) : "A long item which scrolls " + String(i)));
+      }
+      lcd::StressHarness harness(1000 + columns * rows, tickLimit);
+      harness.addView(menu);
+      harness.setRefusalRate(10);
+      harness.setOnTick([&](const uint32_t& random) {
+        lcd::MenuView::MenuItem& item = *items[random % items.size()];
+        if (random % 7 == 0) {
+          item.setVisible(!item.isVisible());
+        }
+        else if (random % 11 == 0) {
+          item.setEnabled(!item.isEnabled());
+        }
+        else if (random % 13 == 0) {
+          item.setText("Changed " + String((int)(random % 1000)));
+        }
+      });
+      print(columns, rows, "MenuView", harness.run(menu, ticks));
+    }
+
+    {
+      lcd::MenuView menu(&display, "empty", &encoder, "Empty", columns, rows);
+      lcd::StressHarness harness(2000 + columns * rows, tickLimit);
+      harness.addView(menu);
+      print(columns, rows, "MenuView (empty)", harness.run(menu, ticks / 10));
+    }
+
+    {
+      lcd::StaticMenuView menu(&display, "static", &encoder, staticMenus, columns, rows);
+      lcd::StressHarness harness(1500 + columns * rows, tickLimit);
+      harness.addView(menu);
+      print(columns, rows, "StaticMenuView", harness.run(menu, ticks));
+    }
+
+    {
+      lcd::MemoryMenuSource source(menuFile.data(), menuFile.size());
+      lcd::MenuFileView menu(&display, "file", &encoder, &source, columns, rows);
+      if (!menu.begin()) {
+        printf("invalid menu file\n");
+        failures++;
+      }
+      lcd::StressHarness harness(1700 + columns * rows, tickLimit);
+      harness.addView(menu);
+      print(columns, rows, "MenuFileView", harness.run(menu, ticks));
+    }
+
+    {
+      Source source;
+      lcd::TableView table(&display, "table", &encoder, &source, columns, rows);
+      table.addColumn("A", 4);
+      table.addColumn("B", 6, lcd::TableView::Alignment::right);
+      lcd::StressHarness harness(3000 + columns * rows, tickLimit);
+      harness.addView(table);
+      harness.setOnTick([&](const uint32_t& random) {
+        if (random % 97 == 0) {
+          source.numberOfRows = random % 60;
+          table.invalidate();
+        }
+        else if (random % 13 == 0) {
+          table.sortBy(random % 2, random & 4);
+        }
+      });
+      print(columns, rows, "TableView", harness.run(table, ticks));
+    }
+
+    if ((columns >= 16) && (rows >= 2)) {
+      // a caption longer than the display
+      lcd::ValueEditView<float> editor(&display, "editor", &encoder, "A caption longer than the display", columns, rows,
+                                       -10, 10, 0.5, 1);
+      lcd::StressHarness harness(4000 + columns * rows, tickLimit);
+      harness.addView(editor);
+      print(columns, rows, "ValueEditView", harness.run(editor, ticks));
+    }
+    else {
+      printUnsupported(columns, rows, "ValueEditView");
+    }
+
+    {
+      // a long caption and values up to 9999.9
+      lcd::SparklineView<40> sparkline(&display, "sparkline", &encoder, "Outdoor temp: ", columns, rows);
+      lcd::StressHarness harness(5000 + columns * rows, tickLimit);
+      harness.addView(sparkline);
+      harness.setOnTick([&](const uint32_t& random) {
+        if (random % 3 == 0) {
+          sparkline.addSample((random % 200000) / 10.0f - 10000.0f);
+        }
+      });
+      print(columns, rows, "SparklineView", harness.run(sparkline, ticks));
+    }
+
+    {
+      lcd::MenuView menu(&display, "menu", &encoder, "Bars", columns, rows);
+      BarView bars(&display, &encoder, columns, rows);
+      menu.createMenuItem("Bars", [&](lcd::MenuView::MenuItem*) { lcd::ViewBase::activateView(&bars); });
+      lcd::StressHarness harness(5500 + columns * rows, tickLimit);
+      harness.addView(menu);
+      harness.addView(bars);
+      harness.setOnTick([&](const uint32_t& random) {
+        if (random % 5 == 0) {
+          bars.value = random % 101;
+        }
+      });
+      print(columns, rows, "Bars", harness.run(menu, ticks));
+    }
+
+    if ((columns >= 16) && (rows >= 2)) {
+      // the selection, the value and the last view are restored after
+      // simulated reboots
+      RamStorage storage;
+      lcd::PersistentState state(&storage);
+      state.begin();
+      lcd::MenuView menu(&display, "persisted menu", &encoder, "Persisted", columns, rows);
+      lcd::ValueEditView<float> editor(&display, "persisted editor", &encoder, "Value", columns, rows, -10, 10, 0.5,
+                                       1);
+      for (int i = 0; i < 8; i++) {
+        menu.createMenuItem("Edit " + String(i), [&](lcd::MenuView::MenuItem*) { lcd::ViewBase::activateView(&editor); });
+      }
+      menu.setPersistentState(&state, 1);
+      editor.setPersistentState(&state, 2);
+      lcd::ViewBase::setLastViewState(&state, 3);
+      lcd::StressHarness harness(5800 + columns * rows, tickLimit);
+      harness.addView(menu);
+      harness.addView(editor);
+      harness.setOnTick([&](const uint32_t& random) {
+        if (random % 50 == 0) {
+          state.commit();
+        }
+        if (random % 500 == 0) {
+          state.begin();
+          lcd::ViewBase::activateView(nullptr);
+          lcd::ViewBase::restoreLastView({&menu, &editor}) || (lcd::ViewBase::activateView(&menu), true);
+        }
+      });
+      print(columns, rows, "Persisted views", harness.run(menu, ticks));
+      lcd::ViewBase::setLastViewState(nullptr, 0);
+    }
+    else {
+      printUnsupported(columns, rows, "Persisted views");
+    }
+
+    if (rows >= 2) {
+      lcd::MenuView menu(&display, "menu", &encoder, "Dialogs", columns, rows);
+      lcd::DialogOk dialogOk(&display, &encoder, dialogText, columns, rows);
+      lcd::DialogYesNo dialogYesNo(&display, &encoder, dialogText, columns, rows);
+      lcd::DialogYesNoBack dialogYesNoBack(&display, &encoder, dialogText, columns, rows);
+      menu.createMenuItem("Ok", [&](lcd::MenuView::MenuItem*) { lcd::ViewBase::activateView(&dialogOk); });
+      if (columns >= 10) {
+        menu.createMenuItem("Yes/No", [&](lcd::MenuView::MenuItem*) { lcd::ViewBase::activateView(&dialogYesNo); });
+      }
+      if (columns >= 15) {
+        menu.createMenuItem("Yes/No/Back", [&](lcd::MenuView::MenuItem*) {
+          lcd::ViewBase::activateView(&dialogYesNoBack);
+        });
+      }
+      lcd::StressHarness harness(6000 + columns * rows, tickLimit);
+      harness.addView(menu);
+      harness.addView(dialogOk);
+      harness.addView(dialogYesNo);
+      harness.addView(dialogYesNoBack);
+      print(columns, rows, "Dialogs", harness.run(menu, ticks));
+
+      // the frame is only read, so the LCD is not needed
+      checkDialog(columns, rows, "DialogOk", [&]() { dialogOk.ask(); }, {">OK<"});
+      if (columns >= 10) {
+        checkDialog(columns, rows, "DialogYesNo", [&]() { dialogYesNo.ask(true); }, {">YES<", " No "});
+      }
+      else {
+        printUnsupported(columns, rows, "DialogYesNo");
+      }
+      if (columns >= 15) {
+        checkDialog(columns, rows, "DialogYesNoBack", [&]() { dialogYesNoBack.ask(lcd::DialogYesNoBack::DialogResult::yes); }, {">yes<", " no ", " back "});
+      }
+      else {
+        printUnsupported(columns, rows, "DialogYesNoBack");
+      }
+    }
+    else {
+      printUnsupported(columns, rows, "Dialogs");
+    }
+  }
+
+  printf("stress_harness: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,260 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+/**
+ * Minimal subset of the Arduino API to compile the library on the host.
+ * Print declares flush like the AVR, ESP8266 and ESP32 cores, so classes
+ * derived from Print must not declare a conflicting flush. Like the ESP8266
+ * and ESP32 cores it provides std::function.
+ */
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+
+typedef uint8_t byte;
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define INPUT_PULLUP 2
+#define PROGMEM
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define memcpy_P memcpy
+
+#define B00100 4
+#define B01010 10
+#define B01110 14
+#define B10001 17
+#define B11111 31
+
+inline unsigned long micros() {
+  static const auto start = std::chrono::steady_clock::now();
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+    .count();
+}
+
+inline unsigned long millis() {
+  return micros() / 1000;
+}
+
+inline void delay(unsigned long milliseconds) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+inline void yield() {}
+inline void interrupts() {}
+inline void noInterrupts() {}
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) {
+  return HIGH;
+}
+
+class String {
+protected:
+  std::string text;
+
+public:
+  String() {}
+  String(const char* text)
+    : text(text ? text : "") {}
+  String(const std::string& text)
+    : text(text) {}
+  String(char c)
+    : text(1, c) {}
+  String(int value)
+    : text(std::to_string(value)) {}
+  String(unsigned int value)
+    : text(std::to_string(value)) {}
+  String(long value)
+    : text(std::to_string(value)) {}
+  String(unsigned long value)
+    : text(std::to_string(value)) {}
+  String(double value, unsigned char decimals = 2) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    text = buffer;
+  }
+
+  unsigned int length() const {
+    return text.size();
+  }
+  const char* c_str() const {
+    return text.c_str();
+  }
+  bool isEmpty() const {
+    return text.empty();
+  }
+  bool reserve(unsigned int size) {
+    text.reserve(size);
+    return true;
+  }
+  int indexOf(char c) const {
+    const size_t position = text.find(c);
+    return position == std::string::npos ? -1 : (int)position;
+  }
+  String substring(unsigned int from) const {
+    return from > text.size() ? String() : String(text.substr(from));
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+      std::swap(from, to);
+    }
+    return from > text.size() ? String() : String(text.substr(from, to - from));
+  }
+  char charAt(unsigned int index) const {
+    return index < text.size() ? text[index] : 0;
+  }
+  char operator[](unsigned int index) const {
+    return charAt(index);
+  }
+  char& operator[](unsigned int index) {
+    return text[index];
+  }
+  long toInt() const {
+    return atol(text.c_str());
+  }
+  bool concat(const String& other) {
+    text += other.text;
+    return true;
+  }
+  String& operator+=(const String& other) {
+    text += other.text;
+    return *this;
+  }
+  String& operator+=(const char* other) {
+    text += other;
+    return *this;
+  }
+  String& operator+=(char other) {
+    text += other;
+    return *this;
+  }
+  bool operator==(const String& other) const {
+    return text == other.text;
+  }
+  bool operator!=(const String& other) const {
+    return text != other.text;
+  }
+  bool operator==(const char* other) const {
+    return text == other;
+  }
+
+  friend String operator+(const String& a, const String& b) {
+    return String(a.text + b.text);
+  }
+  friend String operator+(const String& a, const char* b) {
+    return String(a.text + b);
+  }
+  friend String operator+(const char* a, const String& b) {
+    return String(a + b.text);
+  }
+  friend String operator+(const String& a, char b) {
+    return String(a.text + b);
+  }
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    for (size_t i = 0; i < size; i++) {
+      written += write(buffer[i]);
+    }
+    return written;
+  }
+  size_t write(const char* text) {
+    return text ? write((const uint8_t*)text, strlen(text)) : 0;
+  }
+  size_t write(const char* buffer, size_t size) {
+    return write((const uint8_t*)buffer, size);
+  }
+  virtual int availableForWrite() {
+    return 0;
+  }
+  virtual void flush() {}
+
+  size_t print(const char* text) {
+    return write(text);
+  }
+  size_t print(char c) {
+    return write((uint8_t)c);
+  }
+  size_t print(const String& text) {
+    return write(text.c_str());
+  }
+  size_t print(int value) {
+    return print(String(value));
+  }
+  size_t print(unsigned int value) {
+    return print(String(value));
+  }
+  size_t print(long value) {
+    return print(String(value));
+  }
+  size_t print(unsigned long value) {
+    return print(String(value));
+  }
+  size_t print(double value, int decimals = 2) {
+    return print(String(value, (unsigned char)decimals));
+  }
+  size_t println(const char* text = "") {
+    return print(text) + print("\r\n");
+  }
+  size_t println(const String& text) {
+    return print(text) + print("\r\n");
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+/**
+ * Serial port which stores the written bytes and returns the bytes in input
+ */
+class HardwareSerial : public Stream {
+public:
+  std::string output;
+  std::string input;
+
+  virtual size_t write(uint8_t c) {
+    output += (char)c;
+    return 1;
+  }
+  using Print::write;
+  virtual int availableForWrite() {
+    return 64;
+  }
+  virtual int available() {
+    return input.size();
+  }
+  virtual int read() {
+    if (input.empty()) {
+      return -1;
+    }
+    const int c = (uint8_t)input[0];
+    input.erase(0, 1);
+    return c;
+  }
+  virtual int peek() {
+    return input.empty() ? -1 : (uint8_t)input[0];
+  }
+};
+
+inline HardwareSerial Serial;
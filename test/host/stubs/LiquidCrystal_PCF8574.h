@@ -0,0 +1,50 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * LCD which stores the written characters in RAM
+ */
+class LiquidCrystal_PCF8574 : public Print {
+public:
+  char screen[8][40];
+  uint8_t characters[8][8];
+  int column = 0;
+  int row = 0;
+  int backlight = 0;
+
+  LiquidCrystal_PCF8574(int address = 0x27) {
+    clear();
+  }
+  void begin(int columns, int rows) {}
+  void clear() {
+    memset(screen, ' ', sizeof(screen));
+    home();
+  }
+  void home() {
+    column = 0;
+    row = 0;
+  }
+  void setCursor(int newColumn, int newRow) {
+    column = newColumn;
+    row = newRow;
+  }
+  void setBacklight(int brightness) {
+    backlight = brightness;
+  }
+  void createChar(int location, byte charmap[]) {
+    memcpy(characters[location & 7], charmap, 8);
+  }
+  virtual size_t write(uint8_t c) {
+    if ((row < 8) && (column < 40)) {
+      screen[row][column] = c;
+    }
+    column++;
+    return 1;
+  }
+  using Print::write;
+};
@@ -0,0 +1,25 @@
+/**
+ * @author    Hugo3132
+ * @copyright 2-clause BSD license
+ */
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Encoder which never turns, the tests inject their events into the
+ * InputManager
+ */
+class RotaryEncoder {
+public:
+  enum class Direction { NOROTATION = 0, CLOCKWISE = 1, COUNTERCLOCKWISE = -1 };
+
+  RotaryEncoder(int pin1 = 0, int pin2 = 0, int pinSwitch = 0) {}
+  void tick() {}
+  Direction getDirection() {
+    return Direction::NOROTATION;
+  }
+  bool getNewClick() {
+    return false;
+  }
+};
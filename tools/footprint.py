@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""
+Reports the RAM and flash used by the components of the library and the
+sizes of its classes. Every component is built into a minimal sketch using
+PlatformIO; the report shows how much each sketch uses in addition to a
+sketch containing only the display and the encoder.
+
+The sizes of the classes are read from the compiler's error messages of a
+probe sketch, so they are exact for the chosen board and build flags.
+
+Usage:
+  footprint.py [--board d1_mini] [--platform espressif8266] [--flags "-DLCD_FEATURE_MARQUEE=0"]
+               [--save report.json] [--compare report.json [--tolerance 64]]
+               [--write-budgets lcd_budgets.h [--headroom 10]]
+
+A header written by --write-budgets can be passed to the build to fail it if
+a class grows beyond its budget:
+  build_flags = -DLCD_SIZE_BUDGETS='"lcd_budgets.h"'
+
+Exits with 1 if --compare finds a component which grew by more than the
+tolerance.
+"""
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+LIB_DEPS = [
+    'https://github.com/mathertel/LiquidCrystal_PCF8574',
+    'https://github.com/hugo3132/RotaryEncoder',
+]
+
+BASELINE = '''
+#include <Arduino.h>
+#include <LiquidCrystal_PCF8574.h>
+#include <RotaryEncoder.h>
+#include <Wire.h>
+%(includes)s
+RotaryEncoder encoder(1, 2, 3);
+LiquidCrystal_PCF8574 display(0x27);
+%(globals)s
+void setup() {
+  Wire.begin();
+  display.begin(20, 4);
+%(setup)s
+}
+
+void loop() {
+  encoder.tick();
+%(loop)s
+}
+'''
+
+STATIC_MENU = '''
+void nothing() {}
+const lcd::StaticMenuEntry entries[] = {{"Entry", lcd::StaticMenuEntry::Type::action, 0, nothing}};
+const lcd::StaticMenu menus[] = {{"Title", entries, 1}};
+'''
+
+TABLE_SOURCE = '''
+class Source : public lcd::TableSource {
+public:
+  virtual int getNumberOfRows() { return 10; }
+  virtual String getCell(const int& row, const uint8_t& column) { return String(row * column); }
+} source;
+'''
+
+# name: (includes, globals, setup, loop)
+COMPONENTS = {
+    'MenuView': ('#include <MenuView.h>',
+                 'lcd::MenuView view(&display, "view", &encoder, "Title", 20, 4);',
+                 '  view.createMenuItem("Entry");\n  lcd::ViewBase::activateView(&view);',
+                 '  lcd::ViewBase::getCurrentView()->tick(false);'),
+    'StaticMenuView': ('#include <StaticMenu.h>',
+                       STATIC_MENU + 'lcd::StaticMenuView view(&display, "view", &encoder, menus, 20, 4);',
+                       '  lcd::ViewBase::activateView(&view);',
+                       '  lcd::ViewBase::getCurrentView()->tick(false);'),
+    'MenuFileView': ('#include <MenuFile.h>',
+                     'const uint8_t data[4] = {0};\n'
+                     'lcd::MemoryMenuSource menuSource(data, sizeof(data));\n'
+                     'lcd::MenuFileView view(&display, "view", &encoder, &menuSource, 20, 4);',
+                     '  view.begin();\n  lcd::ViewBase::activateView(&view);',
+                     '  lcd::ViewBase::getCurrentView()->tick(false);'),
+    'TableView': ('#include <TableView.h>',
+                  TABLE_SOURCE + 'lcd::TableView view(&display, "view", &encoder, &source, 20, 4);',
+                  '  view.addColumn("A", 10, lcd::TableView::Alignment::left);\n  lcd::ViewBase::activateView(&view);',
+                  '  lcd::ViewBase::getCurrentView()->tick(false);'),
+    'ValueEditView': ('#include <ValueEditView.h>',
+                      'lcd::ValueEditView<int> view(&display, "view", &encoder, "Value", 20, 4, 0, 100, 1);',
+                      '  lcd::ViewBase::activateView(&view);',
+                      '  lcd::ViewBase::getCurrentView()->tick(false);'),
+    'SparklineView': ('#include <SparklineView.h>',
+                      'lcd::SparklineView<32> view(&display, "view", &encoder, "Value", 20, 4);',
+                      '  lcd::ViewBase::activateView(&view);',
+                      '  view.addSample(analogRead(A0));\n  lcd::ViewBase::getCurrentView()->tick(false);'),
+    'DialogOk': ('#include <DialogOk.h>',
+                 'lcd::DialogOk dialog(&display, &encoder, "Text", 20, 4);',
+                 '  dialog.showModal();',
+                 ''),
+}
+
+# budget macro: (header, class)
+CLASSES = {
+    'LCD_BUDGET_FRAME': ('Frame.h', 'lcd::Frame'),
+    'LCD_BUDGET_MENU_VIEW': ('MenuView.h', 'lcd::MenuView'),
+    'LCD_BUDGET_MENU_ITEM': ('MenuView.h', 'lcd::MenuView::MenuItem'),
+    'LCD_BUDGET_STATIC_MENU_VIEW': ('StaticMenu.h', 'lcd::StaticMenuView'),
+    'LCD_BUDGET_MENU_FILE_VIEW': ('MenuFile.h', 'lcd::MenuFileView'),
+    'LCD_BUDGET_TABLE_VIEW': ('TableView.h', 'lcd::TableView'),
+    'LCD_BUDGET_DIALOG': ('DialogBase.h', 'lcd::DialogBase'),
+    'LCD_BUDGET_VALUE_EDIT_VIEW': ('ValueEditView.h', 'lcd::ValueEditView<long>'),
+    # the samples are excluded like in the static_assert of SparklineView
+    'LCD_BUDGET_SPARKLINE_VIEW': ('SparklineView.h', 'lcd::SparklineView<1>) - sizeof(lcd::RingBuffer<float, 1>'),
+}
+
+
+def build(sketch, args):
+    """Builds a sketch and returns the output of PlatformIO and the exit code."""
+    directory = tempfile.mkdtemp(prefix='lcd_footprint_')
+    try:
+        os.makedirs(os.path.join(directory, 'src'))
+        with open(os.path.join(directory, 'src', 'main.cpp'), 'w') as source:
+            source.write(sketch)
+        with open(os.path.join(directory, 'platformio.ini'), 'w') as ini:
+            ini.write('[env:footprint]\n'
+                      'platform = %s\n'
+                      'board = %s\n'
+                      'framework = arduino\n'
+                      'build_flags = -Wno-unknown-pragmas -I"%s" %s\n'
+                      'lib_deps =\n  %s\n' % (args.platform, args.board, REPO, args.flags, '\n  '.join(LIB_DEPS)))
+        result = subprocess.run(['pio', 'run', '-d', directory], stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                universal_newlines=True)
+        return result.stdout, result.returncode
+    finally:
+        shutil.rmtree(directory, ignore_errors=True)
+
+
+def usage(output):
+    """Returns RAM and flash in bytes parsed from the output of PlatformIO."""
+    ram = re.search(r'RAM:.*used (\d+) bytes', output)
+    flash = re.search(r'Flash:.*used (\d+) bytes', output)
+    if not ram or not flash:
+        raise RuntimeError('build failed:\n' + output[-2000:])
+    return int(ram.group(1)), int(flash.group(1))
+
+
+def measure_components(args):
+    empty = BASELINE % {'includes': '', 'globals': '', 'setup': '', 'loop': ''}
+    base_ram, base_flash = usage(build(empty, args)[0])
+    report = {}
+    for name, (includes, globals_, setup, loop) in COMPONENTS.items():
+        sketch = BASELINE % {'includes': includes, 'globals': globals_, 'setup': setup, 'loop': loop}
+        ram, flash = usage(build(sketch, args)[0])
+        report[name] = {'ram': ram - base_ram, 'flash': flash - base_flash}
+    return report
+
+
+def measure_classes(args):
+    """Returns the sizes of the classes using one failing probe build."""
+    headers = sorted({header for header, _ in CLASSES.values()})
+    lines = ['#include <%s>' % header for header in headers]
+    lines.append('template <int Id, unsigned int Size> struct Probe;')
+    for index, (_, cls) in enumerate(CLASSES.values()):
+        lines.append('Probe<%d, sizeof(%s)> probe%d;' % (index, cls, index))
+    sketch = BASELINE % {'includes': '\n'.join(lines), 'globals': '', 'setup': '', 'loop': ''}
+    output, _ = build(sketch, args)
+    found = {int(m.group(1)): int(m.group(2)) for m in re.finditer(r'Probe<(\d+), (\d+)u?>', output)}
+    sizes = {}
+    for index, macro in enumerate(CLASSES):
+        if index not in found:
+            raise RuntimeError('size of %s not found:\n%s' % (CLASSES[macro][1], output[-2000:]))
+        sizes[macro] = found[index]
+    return sizes
+
+
+def write_budgets(path, sizes, headroom):
+    with open(path, 'w') as header:
+        header.write('// generated by tools/footprint.py\n#pragma once\n\n')
+        for macro, size in sizes.items():
+            header.write('#define %s %d\n' % (macro, size + size * headroom // 100))
+
+
+def compare(report, reference, tolerance):
+    """Prints the differences and returns False if something grew too much."""
+    ok = True
+    for name, values in report['components'].items():
+        old = reference.get('components', {}).get(name)
+        if not old:
+            continue
+        for key in ('ram', 'flash'):
+            delta = values[key] - old[key]
+            if delta > tolerance:
+                print('%s: %s grew by %d bytes (%d -> %d)' % (name, key, delta, old[key], values[key]))
+                ok = False
+    for macro, size in report['sizes'].items():
+        old = reference.get('sizes', {}).get(macro)
+        if old is not None and size > old:
+            print('%s: sizeof grew from %d to %d bytes' % (macro, old, size))
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--board', default='d1_mini')
+    parser.add_argument('--platform', default='espressif8266')
+    parser.add_argument('--flags', default='', help='additional build flags, e.g. feature switches')
+    parser.add_argument('--save', help='write the report as JSON')
+    parser.add_argument('--compare', help='compare with a report written by --save')
+    parser.add_argument('--tolerance', type=int, default=0, help='allowed growth in bytes for --compare')
+    parser.add_argument('--write-budgets', help='write the sizes as header for LCD_SIZE_BUDGETS')
+    parser.add_argument('--headroom', type=int, default=10, help='percent added to the budgets')
+    args = parser.parse_args()
+
+    report = {'board': args.board, 'flags': args.flags,
+              'components': measure_components(args), 'sizes': measure_classes(args)}
+
+    print('%-16s %8s %8s' % ('component', 'RAM', 'flash'))
+    for name, values in report['components'].items():
+        print('%-16s %8d %8d' % (name, values['ram'], values['flash']))
+    print()
+    print('%-28s %6s' % ('class', 'sizeof'))
+    for macro, size in report['sizes'].items():
+        print('%-28s %6d' % (macro, size))
+
+    if args.save:
+        with open(args.save, 'w') as output:
+            json.dump(report, output, indent=2)
+    if args.write_budgets:
+        write_budgets(args.write_budgets, report['sizes'], args.headroom)
+    if args.compare:
+        with open(args.compare) as reference:
+            if not compare(report, json.load(reference), args.tolerance):
+                sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+Compiles a menu description (JSON, or YAML if PyYAML is installed) into the
+binary format read by lcd::MenuFileView.
+
+Input:
+  {
+    "menus": [
+      {"id": "main", "title": "Main", "items": [
+        {"text": "Start", "action": "start"},
+        {"text": "Settings", "menu": "settings"}
+      ]},
+      {"id": "settings", "title": "Settings", "items": [
+        {"text": "Reset", "action": 7},
+        {"text": "Back", "back": true}
+      ]}
+    ]
+  }
+
+The first menu is the root. Links refer to the id or the index of a menu.
+Actions are numbers or names. Names get the smallest numbers which are not
+used by numbered actions and can be written to a C++ header using --header.
+
+Usage:
+  menu_compiler.py menu.json menu.bin [--header MenuActions.h] [--columns 20]
+"""
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b'LCDM'
+VERSION = 1
+ACTION, LINK, BACK = 0, 1, 2
+
+
+def load(path):
+    with open(path, encoding='utf-8') as source:
+        if path.endswith(('.yaml', '.yml')):
+            import yaml
+            return yaml.safe_load(source)
+        return json.load(source)
+
+
+def compile_menus(description, columns=None):
+    """Returns the binary file and the numbered action names."""
+    menus = description['menus']
+    if not menus:
+        raise ValueError('at least one menu is required')
+    if len(menus) > 0xFFFF:
+        raise ValueError('too many menus')
+    ids = {menu.get('id', str(index)): index for index, menu in enumerate(menus)}
+    warnings = []
+
+    # names get the smallest numbers which are not used by numbered actions
+    used = {item['action'] for menu in menus for item in menu.get('items', [])
+            if isinstance(item.get('action'), int)}
+    actions = {}
+
+    def action_number(name):
+        if name not in actions:
+            number = 0
+            while number in used:
+                number += 1
+            used.add(number)
+            actions[name] = number
+        return actions[name]
+
+    # identical texts are stored once
+    texts = {}
+    text_data = bytearray()
+
+    def text_offset(text):
+        encoded = text.encode('latin-1')
+        if len(encoded) > 255:
+            raise ValueError('text too long: ' + text)
+        if encoded not in texts:
+            texts[encoded] = len(text_data)
+            text_data.extend(bytes([len(encoded)]) + encoded)
+        return texts[encoded]
+
+    header_size = 8 + 4 * len(menus)
+    menu_records = []
+    for menu in menus:
+        items = menu.get('items', [])
+        if not items or len(items) > 0xFFFF:
+            raise ValueError('menu %s must have 1..65535 items' % menu.get('id'))
+        title = menu.get('title', '')
+        if columns and len(title) > columns:
+            warnings.append('title "%s" is animated' % title)
+        record = [text_offset(title), len(items), []]
+        for item in items:
+            text = item['text']
+            if columns and len(text) + 2 > columns:
+                warnings.append('item "%s" is animated' % text)
+            if item.get('back'):
+                entry = (BACK, 0)
+            elif 'menu' in item:
+                target = item['menu']
+                target = ids.get(target, target)
+                if not isinstance(target, int) or not 0 <= target < len(menus):
+                    raise ValueError('unknown menu %r' % item['menu'])
+                entry = (LINK, target)
+            else:
+                action = item.get('action', 0)
+                if isinstance(action, str):
+                    action = action_number(action)
+                if not 0 <= action <= 0xFFFF:
+                    raise ValueError('invalid action %r' % action)
+                entry = (ACTION, action)
+            record[2].append((text_offset(text),) + entry)
+        menu_records.append(record)
+
+    # layout: header, menus with their items, texts
+    offsets = []
+    position = header_size
+    for record in menu_records:
+        offsets.append(position)
+        position += 8 + 8 * len(record[2])
+    text_base = position
+
+    data = bytearray(MAGIC + struct.pack('<BBH', VERSION, 0, len(menus)))
+    data += struct.pack('<%dI' % len(offsets), *offsets)
+    for title, count, items in menu_records:
+        data += struct.pack('<IHH', text_base + title, count, 0)
+        for text, kind, target in items:
+            data += struct.pack('<IBBH', text_base + text, kind, 0, target)
+    data += text_data
+    return bytes(data), actions, warnings
+
+
+def write_header(path, actions):
+    with open(path, 'w', encoding='utf-8') as header:
+        header.write('// generated by menu_compiler.py\n#pragma once\n\n#include <stdint.h>\n\n')
+        header.write('enum MenuAction : uint16_t {\n')
+        for name, number in sorted(actions.items(), key=lambda item: item[1]):
+            header.write('  %s = %d,\n' % (name, number))
+        header.write('};\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input')
+    parser.add_argument('output')
+    parser.add_argument('--header', help='write the numbered action names to a C++ header')
+    parser.add_argument('--columns', type=int, help='warn about texts which do not fit the display')
+    args = parser.parse_args()
+
+    try:
+        data, actions, warnings = compile_menus(load(args.input), args.columns)
+    except (ValueError, KeyError) as error:
+        sys.exit('error: %s' % error)
+    for warning in warnings:
+        print('warning: ' + warning, file=sys.stderr)
+    with open(args.output, 'wb') as output:
+        output.write(data)
+    if args.header:
+        write_header(args.header, actions)
+    print('%d bytes' % len(data))
+
+
+if __name__ == '__main__':
+    main()
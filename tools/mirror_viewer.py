@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+Shows the screen mirrored by lcd::MirrorSink in a terminal.
+
+Usage:
+  mirror_viewer.py /dev/ttyUSB0 [--baud 115200] [--columns 20] [--rows 4]
+  mirror_viewer.py capture.bin --dump
+
+Reading from a serial port requires pyserial. Special characters are shown
+as shaded blocks depending on the number of set pixels. Bytes which are not
+part of a valid message, e.g. log output on the same port, are skipped.
+"""
+import argparse
+import sys
+
+CLEAR = 0x01
+BACKLIGHT_OFF = 0x02
+BACKLIGHT_ON = 0x03
+GLYPH = 0x08
+CELLS = 0x10
+SHORT_CELLS = 0x80
+SYNC = 0xFE
+RESYNC_REQUEST = b'\x05'
+
+SHADES = ' ░▒▓█'
+
+
+class Screen:
+    def __init__(self, columns, rows):
+        self.columns = columns
+        self.rows = rows
+        self.cells = [[0x20] * columns for _ in range(rows)]
+        self.glyphs = [[0] * 8 for _ in range(8)]
+        self.backlight = True
+
+    def clear(self):
+        for row in self.cells:
+            row[:] = [0x20] * self.columns
+
+    def write(self, column, row, data):
+        if row >= self.rows:
+            return
+        for i, character in enumerate(data):
+            if column + i < self.columns:
+                self.cells[row][column + i] = character
+
+    def character(self, code):
+        if code < 8:
+            pixels = sum(bin(line & 0x1F).count('1') for line in self.glyphs[code])
+            return SHADES[round(pixels * (len(SHADES) - 1) / 40)]
+        if code == 0xFF:
+            return SHADES[-1]
+        if 0x20 <= code < 0x7F:
+            return chr(code)
+        return '?'
+
+    def render(self):
+        border = '+' + '-' * self.columns + '+'
+        lines = [border]
+        for row in self.cells:
+            lines.append('|' + ''.join(self.character(c) for c in row) + '|')
+        lines.append(border + ('' if self.backlight else ' (backlight off)'))
+        return '\n'.join(lines)
+
+
+class Decoder:
+    """Incremental decoder, bytes may arrive in arbitrary chunks."""
+
+    def __init__(self, screen):
+        self.screen = screen
+        self.buffer = bytearray()
+
+    def feed(self, data):
+        """Returns True if the screen changed."""
+        self.buffer += data
+        changed = False
+        while self.buffer:
+            used = self.decode()
+            if used == 0:
+                break
+            del self.buffer[:used]
+            changed = True
+        return changed
+
+    def decode(self):
+        """Applies the first message of the buffer and returns the number of
+        used bytes or 0 if the message is incomplete."""
+        b = self.buffer
+        start = b.find(SYNC)
+        if start != 0:
+            # skip other output
+            return len(b) if start < 0 else start
+        length = self.message_length()
+        if length == 0 or len(b) < length:
+            return 0
+        if checksum(b[1:length - 1]) != b[length - 1]:
+            # the sync byte was part of other output
+            return 1
+        self.apply(b[1], b[2:length - 1])
+        return length
+
+    def message_length(self):
+        """Returns the length of the first message including the sync byte
+        and the checksum or 0 if the length is not received yet."""
+        b = self.buffer
+        if len(b) < 2:
+            return 0
+        op = b[1]
+        if op & SHORT_CELLS:
+            return 4 + b[2] if len(b) > 2 else 0
+        if op & 0xF0 == CELLS:
+            return 5 + b[3] if len(b) > 3 else 0
+        if op & 0xF8 == GLYPH:
+            return 11
+        return 3
+
+    def apply(self, op, data):
+        if op & SHORT_CELLS:
+            self.screen.write(op & 0x1F, (op >> 5) & 0x03, data[1:])
+        elif op & 0xF0 == CELLS:
+            self.screen.write(data[0], op & 0x0F, data[2:])
+        elif op & 0xF8 == GLYPH:
+            self.screen.glyphs[op & 0x07] = list(data)
+        elif op == CLEAR:
+            self.screen.clear()
+        elif op in (BACKLIGHT_OFF, BACKLIGHT_ON):
+            self.screen.backlight = op == BACKLIGHT_ON
+
+
+def checksum(data):
+    value = 0xA5
+    for byte in data:
+        value = (((value << 1) | (value >> 7)) & 0xFF) ^ byte
+    return value
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('source', help='serial port or file with captured data')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--columns', type=int, default=20)
+    parser.add_argument('--rows', type=int, default=4)
+    parser.add_argument('--dump', action='store_true', help='read a capture file and print the final screen')
+    args = parser.parse_args()
+
+    screen = Screen(args.columns, args.rows)
+    decoder = Decoder(screen)
+
+    if args.dump:
+        with open(args.source, 'rb') as capture:
+            decoder.feed(capture.read())
+        print(screen.render())
+        return
+
+    import serial
+    port = serial.Serial(args.source, args.baud, timeout=0.1)
+    port.write(RESYNC_REQUEST)
+    sys.stdout.write('\x1b[2J')
+    try:
+        while True:
+            data = port.read(256)
+            if data and decoder.feed(data):
+                sys.stdout.write('\x1b[H' + screen.render() + '\n')
+                sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
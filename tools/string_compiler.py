@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+Compiles translated texts (JSON, or YAML if PyYAML is installed) into one
+binary string table per language read by lcd::StringTable.
+
+Input:
+  {
+    "languages": ["en", "de"],
+    "texts": [
+      {"id": "start", "en": "Start", "de": "Starten"},
+      {"id": "settings", "en": "Settings", "de": "Einstellungen"}
+    ]
+  }
+
+Every text gets the number of its position. Missing translations are
+replaced by the text of the first language. The numbers can be written to a
+C++ header using --header.
+
+Usage:
+  string_compiler.py texts.json output_directory [--header TextKeys.h] [--columns 20] [--progmem]
+
+Writes <language>.bin for each language, or <language>.h containing the
+table as PROGMEM array texts_<language> if --progmem is used.
+"""
+import argparse
+import json
+import os
+import struct
+import sys
+
+MAGIC = b'LCDS'
+VERSION = 1
+
+
+def load(path):
+    with open(path, encoding='utf-8') as source:
+        if path.endswith(('.yaml', '.yml')):
+            import yaml
+            return yaml.safe_load(source)
+        return json.load(source)
+
+
+def compile_tables(description, columns=None):
+    """Returns the binary table of each language and the numbered ids."""
+    languages = description['languages']
+    texts = description['texts']
+    if not languages:
+        raise ValueError('at least one language is required')
+    if len(texts) >= 0xFFFF:
+        raise ValueError('too many texts')
+    ids = [text['id'] for text in texts]
+    if len(set(ids)) != len(ids):
+        raise ValueError('duplicate ids')
+    warnings = []
+
+    tables = {}
+    for language in languages:
+        # identical texts are stored once
+        offsets = {}
+        text_data = bytearray()
+        entries = []
+        for text in texts:
+            value = text.get(language)
+            if value is None:
+                warnings.append('"%s" is not translated to %s' % (text['id'], language))
+                value = text[languages[0]]
+            encoded = value.encode('latin-1')
+            if len(encoded) > 255:
+                raise ValueError('text too long: ' + value)
+            # dialog texts are split into lines, menu items need two columns
+            # for the selection marker and the scrollbar
+            if columns and max(len(line) for line in value.split('\n')) + 2 > columns:
+                warnings.append('%s text "%s" does not fit' % (language, value))
+            if encoded not in offsets:
+                offsets[encoded] = len(text_data)
+                text_data.extend(bytes([len(encoded)]) + encoded)
+            entries.append(offsets[encoded])
+
+        text_base = 8 + 4 * len(texts)
+        data = bytearray(MAGIC + struct.pack('<BBH', VERSION, 0, len(texts)))
+        data += struct.pack('<%dI' % len(entries), *[text_base + offset for offset in entries])
+        data += text_data
+        tables[language] = bytes(data)
+    return tables, {name: number for number, name in enumerate(ids)}, warnings
+
+
+def write_header(path, ids):
+    with open(path, 'w', encoding='utf-8') as header:
+        header.write('// generated by string_compiler.py\n#pragma once\n\n#include <stdint.h>\n\n')
+        header.write('enum TextKey : uint16_t {\n')
+        for name, number in sorted(ids.items(), key=lambda item: item[1]):
+            header.write('  %s = %d,\n' % (name, number))
+        header.write('};\n')
+
+
+def write_progmem(path, language, data):
+    with open(path, 'w', encoding='utf-8') as header:
+        header.write('// generated by string_compiler.py\n#pragma once\n\n#include <Arduino.h>\n\n')
+        header.write('const uint8_t texts_%s[] PROGMEM = {\n' % language)
+        for start in range(0, len(data), 16):
+            header.write('  %s,\n' % ', '.join('0x%02x' % byte for byte in data[start:start + 16]))
+        header.write('};\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input')
+    parser.add_argument('output', help='directory receiving one table per language')
+    parser.add_argument('--header', help='write the numbered ids to a C++ header')
+    parser.add_argument('--columns', type=int, help='warn about texts which do not fit the display')
+    parser.add_argument('--progmem', action='store_true', help='write the tables as PROGMEM arrays')
+    args = parser.parse_args()
+
+    try:
+        tables, ids, warnings = compile_tables(load(args.input), args.columns)
+    except (ValueError, KeyError) as error:
+        sys.exit('error: %s' % error)
+    for warning in warnings:
+        print('warning: ' + warning, file=sys.stderr)
+    os.makedirs(args.output, exist_ok=True)
+    for language, data in tables.items():
+        if args.progmem:
+            write_progmem(os.path.join(args.output, language + '.h'), language, data)
+        else:
+            with open(os.path.join(args.output, language + '.bin'), 'wb') as output:
+                output.write(data)
+        print('%s: %d bytes' % (language, len(data)))
+    if args.header:
+        write_header(args.header, ids)
+
+
+if __name__ == '__main__':
+    main()